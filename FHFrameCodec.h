@@ -0,0 +1,276 @@
+/*
+	Author: Brent Pease
+
+	The MIT License (MIT)
+
+	Copyright (c) 2015-FOREVER Brent Pease
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+/*
+	ABOUT
+
+	A compact wire format for frames of 8 bit rgb leds streamed over a slow link.
+
+	A packet is a flags byte, the index of the first led as 2 little endian bytes, then a list of ops.
+	Each op is one byte, the top 2 bits give the type and the low 6 bits give the led count minus 1:
+		skip		The leds are unchanged from the previous frame, only allowed in delta frames
+		run			The leds are all set to the one rgb color that follows
+		literal		Each led's rgb color follows
+
+	A keyframe sets every led it covers so it can be decoded without the previous frame, a delta frame only works if the previous frame was decoded.
+	This header has no dependencies so the sender can use the same code to encode frames.
+*/
+
+#ifndef _FHFRAMECODEC_H_
+#define _FHFRAMECODEC_H_
+
+#include <stdint.h>
+#include <string.h>
+
+enum
+{
+	eFrameCodecFlag_KeyFrame = 1 << 0,	// The packet does not depend on the previous frame
+	eFrameCodecFlag_FrameEnd = 1 << 1,	// This is the last packet of the frame
+
+	eFrameCodecHeaderSize = 3,
+
+	eFrameOp_Skip = 0x00,
+	eFrameOp_Run = 0x40,
+	eFrameOp_Literal = 0x80,
+	eFrameOp_TypeMask = 0xC0,
+	eFrameOp_MaxCount = 64,
+};
+
+// Return true if every op of a packet is valid and fits inLEDCount leds and the packet, this writes nothing
+inline bool
+FrameCodecValidate(
+	uint8_t const*	inPacket,
+	int				inPacketSize,
+	int				inLEDCount)
+{
+	if(inPacketSize < eFrameCodecHeaderSize)
+	{
+		return false;
+	}
+
+	bool			keyFrame = (inPacket[0] & eFrameCodecFlag_KeyFrame) != 0;
+	int				ledItr = inPacket[1] | (inPacket[2] << 8);
+	uint8_t const*	data = inPacket + eFrameCodecHeaderSize;
+	uint8_t const*	dataEnd = inPacket + inPacketSize;
+
+	while(data < dataEnd)
+	{
+		uint8_t	op = *data & eFrameOp_TypeMask;
+		int		count = (*data++ & ~eFrameOp_TypeMask) + 1;
+		int		colorBytes;
+
+		if(ledItr + count > inLEDCount)
+		{
+			return false;
+		}
+
+		switch(op)
+		{
+			case eFrameOp_Skip:
+				if(keyFrame)
+				{
+					return false;
+				}
+				colorBytes = 0;
+				break;
+
+			case eFrameOp_Run:
+				colorBytes = 3;
+				break;
+
+			case eFrameOp_Literal:
+				colorBytes = count * 3;
+				break;
+
+			default:
+				return false;
+		}
+
+		if(dataEnd - data < colorBytes)
+		{
+			return false;
+		}
+
+		data += colorBytes;
+		ledItr += count;
+	}
+
+	return true;
+}
+
+// Decode the ops of a packet into ioRGB which holds inLEDCount rgb leds written by previous frames
+// Return false if the packet is not valid, the whole packet is checked first so a bad packet leaves ioRGB as it was
+// Only the leds that change are written and outDirtyStart to outDirtyEnd is set to cover them
+inline bool
+FrameCodecDecode(
+	uint8_t const*	inPacket,
+	int				inPacketSize,
+	uint8_t*		ioRGB,
+	int				inLEDCount,
+	int&			outDirtyStart,
+	int&			outDirtyEnd)
+{
+	outDirtyStart = inLEDCount;
+	outDirtyEnd = 0;
+
+	if(FrameCodecValidate(inPacket, inPacketSize, inLEDCount) == false)
+	{
+		return false;
+	}
+
+	int				ledItr = inPacket[1] | (inPacket[2] << 8);
+	uint8_t const*	data = inPacket + eFrameCodecHeaderSize;
+	uint8_t const*	dataEnd = inPacket + inPacketSize;
+
+	while(data < dataEnd)
+	{
+		uint8_t	op = *data & eFrameOp_TypeMask;
+		int		count = (*data++ & ~eFrameOp_TypeMask) + 1;
+
+		if(op == eFrameOp_Skip)
+		{
+			ledItr += count;
+			continue;
+		}
+
+		for(int itr = 0; itr < count; ++itr, ++ledItr)
+		{
+			uint8_t*	led = ioRGB + ledItr * 3;
+
+			if(led[0] != data[0] || led[1] != data[1] || led[2] != data[2])
+			{
+				led[0] = data[0];
+				led[1] = data[1];
+				led[2] = data[2];
+				outDirtyStart = ledItr < outDirtyStart ? ledItr : outDirtyStart;
+				outDirtyEnd = ledItr + 1;
+			}
+
+			if(op == eFrameOp_Literal)
+			{
+				data += 3;
+			}
+		}
+
+		if(op == eFrameOp_Run)
+		{
+			data += 3;
+		}
+	}
+
+	return true;
+}
+
+// Encode inLEDCount rgb leds starting at inFirstLED, inPrevRGB is NULL for a keyframe or the previous frame sent for a delta frame
+// Return the packet size or 0 if it does not fit in inMaxPacketSize, the sender can then split the leds over several packets
+inline int
+FrameCodecEncode(
+	uint8_t const*	inRGB,
+	uint8_t const*	inPrevRGB,
+	int				inFirstLED,
+	int				inLEDCount,
+	bool			inFrameEnd,
+	uint8_t*		outPacket,
+	int				inMaxPacketSize)
+{
+	if(inMaxPacketSize < eFrameCodecHeaderSize)
+	{
+		return 0;
+	}
+
+	outPacket[0] = uint8_t((inPrevRGB == NULL ? eFrameCodecFlag_KeyFrame : 0) | (inFrameEnd ? eFrameCodecFlag_FrameEnd : 0));
+	outPacket[1] = uint8_t(inFirstLED & 0xFF);
+	outPacket[2] = uint8_t(inFirstLED >> 8);
+
+	int	packetSize = eFrameCodecHeaderSize;
+	int	ledEnd = inFirstLED + inLEDCount;
+	int	ledItr = inFirstLED;
+
+	while(ledItr < ledEnd)
+	{
+		int	maxCount = ledEnd - ledItr < eFrameOp_MaxCount ? ledEnd - ledItr : eFrameOp_MaxCount;
+		int	count = 1;
+
+		// Prefer skipping unchanged leds, then runs of one color, otherwise send literal colors up to the next skip or run
+		if(inPrevRGB != NULL && memcmp(inRGB + ledItr * 3, inPrevRGB + ledItr * 3, 3) == 0)
+		{
+			while(count < maxCount && memcmp(inRGB + (ledItr + count) * 3, inPrevRGB + (ledItr + count) * 3, 3) == 0)
+			{
+				++count;
+			}
+
+			if(packetSize + 1 > inMaxPacketSize)
+			{
+				return 0;
+			}
+			outPacket[packetSize++] = uint8_t(eFrameOp_Skip | (count - 1));
+		}
+		else if(count < maxCount && memcmp(inRGB + ledItr * 3, inRGB + (ledItr + 1) * 3, 3) == 0)
+		{
+			while(count < maxCount && memcmp(inRGB + ledItr * 3, inRGB + (ledItr + count) * 3, 3) == 0)
+			{
+				++count;
+			}
+
+			if(packetSize + 4 > inMaxPacketSize)
+			{
+				return 0;
+			}
+			outPacket[packetSize++] = uint8_t(eFrameOp_Run | (count - 1));
+			memcpy(outPacket + packetSize, inRGB + ledItr * 3, 3);
+			packetSize += 3;
+		}
+		else
+		{
+			while(count < maxCount)
+			{
+				uint8_t const*	next = inRGB + (ledItr + count) * 3;
+
+				if((inPrevRGB != NULL && memcmp(next, inPrevRGB + (ledItr + count) * 3, 3) == 0)
+					|| (ledItr + count + 1 < ledEnd && memcmp(next, next + 3, 3) == 0))
+				{
+					break;
+				}
+				++count;
+			}
+
+			if(packetSize + 1 + count * 3 > inMaxPacketSize)
+			{
+				return 0;
+			}
+			outPacket[packetSize++] = uint8_t(eFrameOp_Literal | (count - 1));
+			memcpy(outPacket + packetSize, inRGB + ledItr * 3, count * 3);
+			packetSize += count * 3;
+		}
+
+		ledItr += count;
+	}
+
+	return packetSize;
+}
+
+#endif /* _FHFRAMECODEC_H_ */
@@ -30,8 +30,11 @@
 	This is the main module for a front of house lighting project.
 */
 
+#include <stddef.h>
+
 #if !defined(WIN32)
 	#include <OctoWS2811.h>
+	#include <SD.h>
 #endif
 
 #include <ELModule.h>
@@ -47,30 +50,140 @@
 #include <ELCalendarEvent.h>
 #include <ELOutdoorLightingControl.h>
 
+#include "FHFrameCodec.h"
+
+// Define MUseFloatPixels as 1 to have patterns render into float pixels, otherwise patterns render into packed 8 bit pixels and intensity is applied with integer math
+#if !defined(MUseFloatPixels)
+	#define MUseFloatPixels 0
+#endif
+
 enum
 {
 	eTransformerRelayPin = 17,		// This output pin controls the relay for the main power transformer to the leds
 	eToggleButtonPin = 9,			// This input pin is for a pushbutton that forces the leds on or off and can activate a test pattern and cycle through the holiday base patterns
 	eRTCChipSelect = 10,
+	eSDChipSelect = 15,				// The chip select for the sd card holding frame sequences, it shares the SPI bus with the RTC
 	eMotionSensorPin = 22,			// This pin is triggered by the external motion sensor
 	eESP8266ResetPin = 23,
 
-	ePanelCount = 10,				// This is the number of led panels that go across the roof soffit
 	eLEDsPerPanel = 38,				// This is the number of leds per panel
 	eLEDPanelsCenterToRight = 4,	// This is the number of panels on the right side of the house roof (control system is at top center of the gable roof)
 	eLEDPanelsCenterToLeft = 6,		// This is the number of panels on the left side of the house roof (control system is at top center of the gable roof)
-	eLEDsPerStrip = eLEDPanelsCenterToLeft * eLEDsPerPanel,	// The total leds per strip is the max of the two strips in use
-	eLEDCount = ePanelCount * eLEDsPerPanel,	// The total number of leds across the roof
 
 	eLEDStripCenterToRight = 3,		// This is the Octo strip number (starting from 0) that goes from the center towards the right
 	eLEDStripCenterToLeft = 0,		// This is the Octo strip number (starting from 0) that goes from the center towards the left
 
+	eOctoStripCount = 8,			// The number of parallel strips OctoWS2811 drives
+	eBytesPerLED = 24,				// The bytes of octo display memory per led offset, one byte per color bit with one bit per strip
+
 	ePushCount_CyclePatterns = 3,	// The number of pushes to trigger the cycling of the holiday base patterns
 	ePushCount_TestPattern = 4,		// The number of pushes to trigger the test pattern
 
 	eCyclePatternTime = 4000,	// The duration in ms for each holiday base pattern when cycling
 
-	eMaxPatternCount = 10,
+	eMaxPatternCount = 16,
+	eBuiltInPatternCount = 9,	// The patterns defined in this file, the user pattern slots follow them in gPatternList
+	eMaxEffectCount = 8,
+	eMaxLayers = 4,				// The number of layers that can be composited over the base pattern at once
+
+	eUserPatternSlots = 4,		// The number of user pattern descriptors kept in the settings
+	eUserPaletteMax = 8,		// The most colors in a user pattern palette
+	eUserRunMax = 8,			// The most runs in a user pattern
+	eUserScrollStepMS = 10,		// The units of the user pattern scroll period
+
+	eInvalidScale = 0xFFFF,		// An intensity scale value that never matches a real one, forces a requantize
+
+	eSettingsVersion = 12,		// Increment this whenever SSettings changes
+
+	eUpdateTickUS = 2000,				// The period the module is polled at, frames are rendered at the configured frame period
+	eDefaultFramePeriodUS = 30000,		// The frame period used when none is configured
+	eStatusPageSize = 1024,		// The size of the cached home page html and json status
+	eStatusTailSize = 160,		// The size of the part of the status pages that changes every frame and is not cached
+	eSettingsSaveDelayMS = 2000,	// Settings are written to the eeprom once they have not changed for this long
+	eMaxHolidayRanges = 24,		// The most pattern changes in the holiday calendar for one year
+	eCalendarCheckMS = 1000,	// How often the time is checked against the next pattern change
+	eMinValidEpoch = 1451606400,	// 2016-01-01, a clock earlier than this has not been set yet
+	eBootStateMaxMS = 30000,	// How long the boot state is shown after the clock is valid if the lighting control has not given the led state
+	eStreamTimeoutMS = 2000,	// Streaming stops and the holiday pattern returns if no packet arrives for this long
+	eStreamMaxPacketLEDs = 170,	// The most leds in one stream packet, the same as an E1.31 universe
+	eStreamMaxCodecPacketSize = 600,	// The most bytes in one FHFrameCodec packet
+	eSyncTimeoutMS = 10000,		// A follower goes back to its own pattern and intensity if no sync state arrives for this long
+	eSyncOffsetWindowMS = 30000,	// The time a follower's clock offset is measured over before it is replaced, this follows drift of the clocks
+	eSyncSlewRate = 16,			// A follower moving back to a slower master clock runs its pattern time 1/eSyncSlewRate slow until it catches up
+	eSequenceBufferCount = 4,	// The number of frames of a sequence prefetched from the sd card
+	eSequenceReadChunk = 512,	// The most bytes read from the sd card per update tick, one sd block so a read never blocks the loop for long
+	eIdleMaxMS = 60000,			// The longest a static frame is left without rendering, this bounds the effect of the rtc being set while idle
+	eIdleLuxPollMS = 1000,		// How often a static frame is rerendered when its intensity follows the lux sensor
+	eFrameRateWindowMS = 1000,	// The time the shown frame rate is measured over
+
+	eDefaultChannelMA = 20,		// The current of one fully on led channel when none is configured
+	eLEDIdleMA = 1,				// The current each led draws when it is off
+	ePowerLimitHysteresis = 2,	// The power limit scale only rises once it can rise by at least this much so it does not hunt
+	ePaletteMax = 8,			// The most colors in a palette pattern
+	eLuxCurvePoints = 5,		// The number of evenly spaced points in the lux brightness to intensity curve
+
+	eTelemetryRingSize = 128,	// The number of telemetry records kept until they are sent, a power of 2
+	eTelemetryBatchRecords = 8,	// The most telemetry records packed into one log message
+	eTelemetryFlushMS = 60000,	// How often the telemetry records are sent to the log
+	eTelemetryFramesMS = 5000,	// How often the frame counters are recorded while frames are being rendered
+
+	eGammaCurveSize = 1021,		// The number of entries in the gamma curve, one more than the largest index (255 * 256) >> 6
+};
+
+// A segment is a contiguous run of leds on one Octo strip
+struct SLEDSegment
+{
+	uint8_t		strip;			// The Octo strip number (starting from 0)
+	uint16_t	stripOffset;	// The index on the strip of the first led of this segment
+	uint16_t	ledCount;		// The number of leds in this segment
+	bool		reversed;		// True if the strip runs right to left facing the house
+};
+
+// The led layout, segments are listed in logical order going from the left side of the house (facing it) to the right side
+// Segments on different strips are refreshed in parallel so the refresh time only depends on the longest strip
+constexpr SLEDSegment	cLEDLayout[] =
+{
+	{eLEDStripCenterToLeft, 0, eLEDPanelsCenterToLeft * eLEDsPerPanel, true},
+	{eLEDStripCenterToRight, 0, eLEDPanelsCenterToRight * eLEDsPerPanel, false},
+};
+
+constexpr int	cLEDSegmentCount = sizeof(cLEDLayout) / sizeof(cLEDLayout[0]);
+
+// Return the total number of leds in the layout starting at the given segment
+constexpr int
+LayoutLEDCount(
+	int	inSegment = 0)
+{
+	return inSegment >= cLEDSegmentCount ? 0 : cLEDLayout[inSegment].ledCount + LayoutLEDCount(inSegment + 1);
+}
+
+// Return the number of leds needed per strip to hold every segment starting at the given segment
+constexpr int
+LayoutLEDsPerStrip(
+	int	inSegment = 0)
+{
+	return inSegment >= cLEDSegmentCount ? 0
+		: (cLEDLayout[inSegment].stripOffset + cLEDLayout[inSegment].ledCount > LayoutLEDsPerStrip(inSegment + 1)
+			? cLEDLayout[inSegment].stripOffset + cLEDLayout[inSegment].ledCount : LayoutLEDsPerStrip(inSegment + 1));
+}
+
+// Return true if every segment starting at the given segment is on a strip OctoWS2811 drives
+constexpr bool
+LayoutStripsValid(
+	int	inSegment = 0)
+{
+	return inSegment >= cLEDSegmentCount || (cLEDLayout[inSegment].strip < eOctoStripCount && LayoutStripsValid(inSegment + 1));
+}
+
+static_assert(LayoutStripsValid(), "cLEDLayout uses a strip number OctoWS2811 does not drive");
+
+enum
+{
+	eLEDCount = LayoutLEDCount(),			// The total number of leds across the roof
+	eLEDsPerStrip = LayoutLEDsPerStrip(),	// The total leds per strip is the max of the strips in use
+	ePanelCount = eLEDCount / eLEDsPerPanel,	// This is the number of led panels that go across the roof soffit
+	eFrameTransferUS = eLEDsPerStrip * 30 + 50,	// The time to send one frame, 30us per led at 800kHz plus the 50us latch, all strips are sent in parallel
+	eMinFramePeriodUS = eFrameTransferUS,		// A shorter frame period would start a frame before the last one has been sent
 };
 
 enum
@@ -78,638 +191,4706 @@ enum
 	eViewMode_Normal,
 	eViewMode_CyclePatterns,
 	eViewMode_TestPattern,
+	eViewMode_Stream,
+	eViewMode_Sequence,
+};
+
+char const*	gViewModeStr[] = {"Normal", "CyclePatterns", "Test", "Stream", "Sequence"};
+
+// The ways a layer is combined with the pixels below it
+enum
+{
+	eBlend_Over,		// The layer color replaces the pixel by its coverage
+	eBlend_Add,			// The layer color is added to the pixel
+	eBlend_Max,			// Each channel is the brighter of the layer and the pixel
+	eBlend_Multiply,	// The pixel is tinted by the layer color
+
+	eBlendCount
 };
 
-char const*	gViewModeStr[] = {"Normal", "CyclePatterns", "Test"};
+char const*	gBlendStr[] = {"over", "add", "max", "multiply"};
+
+// Flags for a stream packet
+enum
+{
+	eStreamFlag_FrameEnd = 1 << 0,	// This is the last packet of a frame, the frame is shown once it arrives
+};
+
+// The stages of a frame that are profiled
+enum
+{
+	ePerfStage_Draw,		// Drawing the pattern into the frame buffer
+	ePerfStage_Scale,		// Scaling the frame buffer into the 8 bit output frame
+	ePerfStage_Blit,		// Writing the output frame into the octo drawing memory
+	ePerfStage_Show,		// leds.show(), copying the drawing memory and starting DMA
+	ePerfStage_Outside,		// The longest time spent outside of Update() since the previous frame, this is the rest of the main loop including the network modules
+
+	ePerfStageCount,
+
+	ePerfRingSize = 32,		// The number of frames the profiling stats are kept for
+};
+
+char const*	gPerfStageStr[] = {"draw", "scale", "blit", "show", "outside"};
 
 const float	cTestPatternPixelsPerSec = 100.0f;	// The speed for the test pattern
 
 class CBasePattern;
+class CLayerEffect;
 
-DMAMEM int		gLEDDisplayMemory[eLEDsPerStrip * 6];
-int				gLEDMap[eLEDCount];
+// OctoWS2811 stores 24 bytes per led offset (one byte per color bit with one bit per strip) so this covers all 8 strips
+// The display memory is read by DMA during a transfer, frames are drawn into the drawing memory and copied over by leds.show()
+DMAMEM int		gLEDDisplayMemory[eLEDsPerStrip * eBytesPerLED / sizeof(int)];
+int				gLEDDrawingMemory[eLEDsPerStrip * eBytesPerLED / sizeof(int)];
 int				gPatternCount;
 CBasePattern*	gPatternList[eMaxPatternCount];
+int				gEffectCount;
+CLayerEffect*	gEffectList[eMaxEffectCount];
 
-// A CBasePattern will fill in an array of these, float is used for easy manipulation by lighting intensity and future effect modifiers
+// A float color, used for settings and for the frame buffer when MUseFloatPixels is set
 struct SFloatPixel
 {
 	float	r, g, b;
 };
 
-struct SSettings
+// A packed 8 bit color, used for the frame buffer by default and for the quantized output sent to the leds
+struct SRGBPixel
 {
-	SFloatPixel	defaultColor;
-	float		defaultIntensity;
-	float		activeIntensity;
-	float		minLux;
-	float		maxLux;
+	uint8_t	r, g, b;
 };
 
-// Patterns inherit from CBasePattern
-class CBasePattern
-{
-public:
-	
-	CBasePattern(
-		)
-	{
-		gPatternList[gPatternCount++] = this;
-	}
+static_assert(sizeof(SRGBPixel) == 3, "Stream packets are decoded straight into arrays of SRGBPixel");
 
-	// This does the actual drawing. must be defined by the derived class
-	virtual void
-	Draw(
-		int				inPixels,
-		SFloatPixel*	inPixelMem) = 0;
+// A CBasePattern will fill in an array of these
+#if MUseFloatPixels
+	typedef SFloatPixel	SPixel;
+#else
+	typedef SRGBPixel	SPixel;
+#endif
 
-	virtual char const*
-	GetName(
-		void) = 0;
-};
+// Set a frame buffer pixel from float color components in the range 0 to 1
+inline void
+SetPixelColor(
+	SPixel&	outPixel,
+	float	inRed,
+	float	inGreen,
+	float	inBlue)
+{
+#if MUseFloatPixels
+	outPixel.r = inRed;
+	outPixel.g = inGreen;
+	outPixel.b = inBlue;
+#else
+	outPixel.r = uint8_t(inRed * 255.0f + 0.5f);
+	outPixel.g = uint8_t(inGreen * 255.0f + 0.5f);
+	outPixel.b = uint8_t(inBlue * 255.0f + 0.5f);
+#endif
+}
 
-// The various patterns are defined below
+// Set a frame buffer pixel from 8 bit color components
+inline void
+SetPixelRGB(
+	SPixel&	outPixel,
+	uint8_t	inRed,
+	uint8_t	inGreen,
+	uint8_t	inBlue)
+{
+#if MUseFloatPixels
+	outPixel.r = float(inRed) / 255.0f;
+	outPixel.g = float(inGreen) / 255.0f;
+	outPixel.b = float(inBlue) / 255.0f;
+#else
+	outPixel.r = inRed;
+	outPixel.g = inGreen;
+	outPixel.b = inBlue;
+#endif
+}
 
-class CXMasPattern : public CBasePattern
+// Blend from inPixelA to inPixelB by inAmount (0 is all A, 255 is all B)
+inline void
+BlendPixel(
+	SPixel const&	inPixelA,
+	SPixel const&	inPixelB,
+	uint8_t			inAmount,
+	SPixel&			outPixel)
 {
-public:
+#if MUseFloatPixels
+	float	amount = float(inAmount) / 255.0f;
+
+	outPixel.r = inPixelA.r + (inPixelB.r - inPixelA.r) * amount;
+	outPixel.g = inPixelA.g + (inPixelB.g - inPixelA.g) * amount;
+	outPixel.b = inPixelA.b + (inPixelB.b - inPixelA.b) * amount;
+#else
+	outPixel.r = uint8_t(inPixelA.r + (((int(inPixelB.r) - int(inPixelA.r)) * inAmount) / 255));
+	outPixel.g = uint8_t(inPixelA.g + (((int(inPixelB.g) - int(inPixelA.g)) * inAmount) / 255));
+	outPixel.b = uint8_t(inPixelA.b + (((int(inPixelB.b) - int(inPixelA.b)) * inAmount) / 255));
+#endif
+}
 
-	CXMasPattern(
-		)
-		:
-		CBasePattern()
-	{
-	}
+inline bool
+PixelsEqual(
+	SPixel const&	inPixelA,
+	SPixel const&	inPixelB)
+{
+	return inPixelA.r == inPixelB.r && inPixelA.g == inPixelB.g && inPixelA.b == inPixelB.b;
+}
 
-	virtual void
-	Draw(
-		int				inPixels,
-		SFloatPixel*	inPixelMem)
-	{
-		for(int itr = 0; itr < inPixels; ++itr)
-		{
-			if(((itr / eLEDsPerPanel) & 1) == 0)
-			{
-				inPixelMem[itr].r = 1.0;
-				inPixelMem[itr].g = 0.0;
-				inPixelMem[itr].b = 0.0;
-			}
-			else
-			{
-				inPixelMem[itr].r = 0.0;
-				inPixelMem[itr].g = 1.0;
-				inPixelMem[itr].b = 0.0;
-			}
-		}
-	}
+// A half open range [start, end) of pixel indices, used to track which part of a frame has changed
+struct SPixelSpan
+{
+	int	start;
+	int	end;
 
-	virtual char const*
-	GetName(
+	void
+	Clear(
 		void)
 	{
-		return "Christmas";
+		start = 0x7FFFFFFF;
+		end = 0;
 	}
-};
-static CXMasPattern	gXMasPattern;
 
-class CValintinePattern : public CBasePattern
-{
-public:
+	bool
+	IsEmpty(
+		void) const
+	{
+		return start >= end;
+	}
 
-	CValintinePattern(
-		)
-		:
-		CBasePattern()
+	void
+	Add(
+		int	inIndex)
 	{
+		Add(inIndex, inIndex + 1);
 	}
 
-	virtual void
-	Draw(
-		int				inPixels,
-		SFloatPixel*	inPixelMem)
+	void
+	Add(
+		int	inStart,
+		int	inEnd)
 	{
-		for(int itr = 0; itr < inPixels; ++itr)
+		if(inStart < start)
 		{
-			inPixelMem[itr].r = 1.0;
-			inPixelMem[itr].g = 0.0;
-			inPixelMem[itr].b = 0.0;
+			start = inStart;
 		}
-	}
 
-	virtual char const*
-	GetName(
-		void)
-	{
-		return "Valentine's Day";
+		if(inEnd > end)
+		{
+			end = inEnd;
+		}
 	}
 };
-static CValintinePattern	gValintinePattern;
 
-class CJuly4Pattern : public CBasePattern
+// The state passed to CBasePattern::Draw() for each frame
+struct SPatternFrame
 {
-public:
+	uint32_t	timeMS;			// The pattern time base, the output of Draw() must only depend on this so equal times always produce equal frames
+	uint32_t	deltaTimeUS;	// The time since the previous frame
+	bool		fullRedraw;		// Set when the pixels do not hold the previous output of this pattern so every pixel must be drawn
+	SPixelSpan	dirty;			// Draw() adds every pixel it changes to this span, an empty span means nothing needs to be redrawn
+};
 
-	CJuly4Pattern(
-		)
-		:
-		CBasePattern()
+// Convert an intensity in the range 0 to 1 into an integer scale in the range 0 to 256
+inline uint16_t
+IntensityToScale(
+	float	inIntensity)
+{
+	if(inIntensity <= 0.0f)
 	{
+		return 0;
 	}
 
-	virtual void
-	Draw(
-		int				inPixels,
-		SFloatPixel*	inPixelMem)
+	if(inIntensity >= 1.0f)
 	{
-		for(int itr = 0; itr < inPixels; ++itr)
-		{
-			int	primaryColor = (itr / eLEDsPerPanel) % 3;
-			if(primaryColor == 0)
-			{
-				inPixelMem[itr].r = 1.0;
-				inPixelMem[itr].g = 0.0;
-				inPixelMem[itr].b = 0.0;
-			}
-			else if(primaryColor == 1)
-			{
-				inPixelMem[itr].r = 1.0;
-				inPixelMem[itr].g = 1.0;
-				inPixelMem[itr].b = 1.0;
-			}
-			else
-			{
-				inPixelMem[itr].r = 0.0;
-				inPixelMem[itr].g = 0.0;
-				inPixelMem[itr].b = 1.0;
-			}
-		}
+		return 256;
 	}
 
-	virtual char const*
-	GetName(
-		void)
-	{
-		return "4th Of July";
-	}
-};
-static CJuly4Pattern	gJuly4Pattern;
+	return uint16_t(inIntensity * 256.0f + 0.5f);
+}
 
-class CHalloweenPattern : public CBasePattern
+// Return the 8 bit channel values of a frame buffer pixel
+inline void
+GetPixelRGB(
+	SPixel const&	inPixel,
+	uint8_t&		outRed,
+	uint8_t&		outGreen,
+	uint8_t&		outBlue)
 {
-public:
+#if MUseFloatPixels
+	outRed = uint8_t(inPixel.r * 255.0f);
+	outGreen = uint8_t(inPixel.g * 255.0f);
+	outBlue = uint8_t(inPixel.b * 255.0f);
+#else
+	outRed = inPixel.r;
+	outGreen = inPixel.g;
+	outBlue = inPixel.b;
+#endif
+}
 
-	CHalloweenPattern(
-		)
-		:
-		CBasePattern()
-	{
-	}
+// Combine the layer color inLayer onto ioPixel with the blend mode inBlend, inCoverage is how much of the layer shows (0 is none, 255 is all)
+inline void
+BlendLayerPixel(
+	uint8_t			inBlend,
+	SPixel const&	inLayer,
+	uint8_t			inCoverage,
+	SPixel&			ioPixel)
+{
+	uint8_t	r, g, b;
+	uint8_t	layerR, layerG, layerB;
+	SPixel	target;
 
-	virtual void
-	Draw(
-		int				inPixels,
-		SFloatPixel*	inPixelMem)
-	{
-		for(int itr = 0; itr < inPixels; ++itr)
-		{
-			if(((itr / eLEDsPerPanel) & 1) == 0)
-			{
-				inPixelMem[itr].r = 1.0f;
-				inPixelMem[itr].g = 0.65f;
-				inPixelMem[itr].b = 0.0f;
-			}
-			else
-			{
-				inPixelMem[itr].r = 0.5f;
-				inPixelMem[itr].g = 0.0f;
-				inPixelMem[itr].b = 0.5f;
-			}
-		}
-	}
+	GetPixelRGB(ioPixel, r, g, b);
+	GetPixelRGB(inLayer, layerR, layerG, layerB);
 
-	virtual char const*
-	GetName(
-		void)
+	switch(inBlend)
 	{
-		return "Halloween";
+		case eBlend_Add:
+			SetPixelRGB(target, uint8_t(r + layerR > 255 ? 255 : r + layerR), uint8_t(g + layerG > 255 ? 255 : g + layerG), uint8_t(b + layerB > 255 ? 255 : b + layerB));
+			break;
+
+		case eBlend_Max:
+			SetPixelRGB(target, r > layerR ? r : layerR, g > layerG ? g : layerG, b > layerB ? b : layerB);
+			break;
+
+		case eBlend_Multiply:
+			SetPixelRGB(target, uint8_t(r * layerR / 255), uint8_t(g * layerG / 255), uint8_t(b * layerB / 255));
+			break;
+
+		default:
+			target = inLayer;
+			break;
 	}
-};
-static CHalloweenPattern	gHalloweenPattern;
 
-class CStPattyPattern : public CBasePattern
+	// A coverage of 0 leaves the pixel exactly as it was
+	BlendPixel(ioPixel, target, inCoverage, ioPixel);
+}
+
+// Scale and correct a frame buffer pixel through per channel 256 entry tables of 8.8 fixed point values and round it to 8 bits
+inline void
+ScalePixel(
+	SPixel const&	inPixel,
+	uint16_t const	inLUT[3][256],
+	SRGBPixel&		outPixel)
 {
-public:
+	uint8_t	r, g, b;
 
-	CStPattyPattern(
-		)
-		:
-		CBasePattern()
-	{
-	}
+	GetPixelRGB(inPixel, r, g, b);
+	outPixel.r = uint8_t((inLUT[0][r] + 0x80) >> 8);
+	outPixel.g = uint8_t((inLUT[1][g] + 0x80) >> 8);
+	outPixel.b = uint8_t((inLUT[2][b] + 0x80) >> 8);
+}
 
-	virtual void
-	Draw(
-		int				inPixels,
-		SFloatPixel*	inPixelMem)
-	{
-		for(int itr = 0; itr < inPixels; ++itr)
-		{
-			inPixelMem[itr].r = 0.0f;
-			inPixelMem[itr].g = 1.0f;
-			inPixelMem[itr].b = 0.0f;
-		}
-	}
+// Like ScalePixel() but the fraction lost by quantizing to 8 bits is kept in ioError and added back on the next frame
+// Over several frames the average output of each led then matches the 8.8 fixed point value
+inline void
+DitherPixel(
+	SPixel const&	inPixel,
+	uint16_t const	inLUT[3][256],
+	SRGBPixel&		ioError,
+	SRGBPixel&		outPixel)
+{
+	uint8_t		r, g, b;
+	uint16_t	value;
 
-	virtual char const*
-	GetName(
-		void)
-	{
-		return "St. Patty's Day";
-	}
-};
-static CStPattyPattern	gStPattyPattern;
+	GetPixelRGB(inPixel, r, g, b);
+
+	// The tables never exceed 255 << 8 so adding an 8 bit error can not overflow
+	value = inLUT[0][r] + ioError.r;
+	outPixel.r = uint8_t(value >> 8);
+	ioError.r = uint8_t(value);
 
-class CEasterPattern : public CBasePattern
+	value = inLUT[1][g] + ioError.g;
+	outPixel.g = uint8_t(value >> 8);
+	ioError.g = uint8_t(value);
+
+	value = inLUT[2][b] + ioError.b;
+	outPixel.b = uint8_t(value >> 8);
+	ioError.b = uint8_t(value);
+}
+
+// Return a free running cycle count, the DWT cycle counter on the Teensy
+inline uint32_t
+GetCycleCount(
+	void)
 {
-public:
+#if defined(ARM_DWT_CYCCNT)
+	return ARM_DWT_CYCCNT;
+#else
+	return micros() * (F_CPU / 1000000);
+#endif
+}
 
-	CEasterPattern(
-		)
-		:
-		CBasePattern()
-	{
-	}
+// A cheap integer hash so every controller picks the same leds for the same time
+inline uint32_t
+Hash(
+	uint32_t	inValue)
+{
+	inValue ^= inValue >> 16;
+	inValue *= 0x7FEB352D;
+	inValue ^= inValue >> 15;
+	inValue *= 0x846CA68B;
+	inValue ^= inValue >> 16;
+	return inValue;
+}
 
-	virtual void
-	Draw(
-		int				inPixels,
-		SFloatPixel*	inPixelMem)
+// Holds the cycle counts of one profiled stage for the last ePerfRingSize frames
+struct SPerfRing
+{
+	uint32_t	samples[ePerfRingSize];
+	uint8_t		next;
+	uint8_t		count;
+
+	void
+	Add(
+		uint32_t	inCycles)
 	{
-		for(int itr = 0; itr < inPixels; ++itr)
+		samples[next] = inCycles;
+		next = uint8_t((next + 1) % ePerfRingSize);
+		if(count < ePerfRingSize)
 		{
-			int	primaryColor = (itr / eLEDsPerPanel) % 7;
-			if(primaryColor == 0)
-			{
-				inPixelMem[itr].r = 1.0f;
-				inPixelMem[itr].g = 1.0f;
-				inPixelMem[itr].b = 0.0f;
-			}
-			else if(primaryColor == 1)
-			{
-				inPixelMem[itr].r = 0.5f;
-				inPixelMem[itr].g = 0.0f;
-				inPixelMem[itr].b = 0.5f;
-			}
-			else if(primaryColor == 2)
-			{
-				inPixelMem[itr].r = 1.0f;
-				inPixelMem[itr].g = 0.0f;
-				inPixelMem[itr].b = 0.0f;
-			}
-			else if(primaryColor == 3)
-			{
-				inPixelMem[itr].r = 0.0f;
-				inPixelMem[itr].g = 1.0f;
-				inPixelMem[itr].b = 0.0f;
-			}
-			else if(primaryColor == 4)
-			{
-				inPixelMem[itr].r = 0.0f;
-				inPixelMem[itr].g = 0.0f;
-				inPixelMem[itr].b = 1.0f;
-			}
-			else if(primaryColor == 5)
-			{
-				inPixelMem[itr].r = 1.0f;
-				inPixelMem[itr].g = 0.41f;
-				inPixelMem[itr].b = 0.71f;
-			}
-			else
-			{
-				inPixelMem[itr].r = 1.0f;
-				inPixelMem[itr].g = 0.65f;
-				inPixelMem[itr].b = 0.0f;
-			}
+			++count;
 		}
 	}
 
-	virtual char const*
-	GetName(
-		void)
+	// Get the min, average and max of the samples in us
+	void
+	GetStatsUS(
+		uint32_t&	outMin,
+		uint32_t&	outAvg,
+		uint32_t&	outMax) const
 	{
-		return "Easter";
-	}
-};
-static CEasterPattern	gEasterPattern;
-
-// This defines our main module
-class COutdoorLightingModule : public CModule, public IRealTimeHandler, public ISunRiseAndSetEventHandler, public IDigitalIOEventHandler, public ICmdHandler, public IInternetHandler, public IOutdoorLightingInterface
-{
-public:
-
-	MModule_Declaration(COutdoorLightingModule)
+		uint32_t	minCycles = 0xFFFFFFFF;
+		uint32_t	maxCycles = 0;
+		uint64_t	totalCycles = 0;
 
-private:
-	
-	COutdoorLightingModule(
-		)
-		:
-		CModule(
-			sizeof(SSettings),
-			0,
-			&settings,
-			30000),
-		leds(eLEDsPerStrip, gLEDDisplayMemory, NULL, WS2811_RGB)
-	{
-		// Create a map of indices going from the left side of the house (facing it) to the right side
-		// This allows us to address the LEDs in linear order left to right given that the octo layout is by strip
-		for(int i = 0; i < eLEDPanelsCenterToLeft * eLEDsPerPanel; ++i)
+		for(int itr = 0; itr < count; ++itr)
 		{
-			gLEDMap[i] = eLEDStripCenterToLeft * eLEDsPerStrip + eLEDPanelsCenterToLeft * eLEDsPerPanel - i - 1;
+			minCycles = samples[itr] < minCycles ? samples[itr] : minCycles;
+			maxCycles = samples[itr] > maxCycles ? samples[itr] : maxCycles;
+			totalCycles += samples[itr];
 		}
 
-		for(int i = 0; i < eLEDPanelsCenterToRight * eLEDsPerPanel; ++i)
+		if(count == 0)
 		{
-			gLEDMap[eLEDPanelsCenterToLeft * eLEDsPerPanel + i] = eLEDStripCenterToRight * eLEDsPerStrip + i;
+			minCycles = 0;
 		}
 
-		viewMode = 0;
-		memset(frameBuffer, 0, sizeof(frameBuffer));
-		basePattern = NULL;
+		outMin = minCycles / (F_CPU / 1000000);
+		outAvg = count > 0 ? uint32_t(totalCycles / count / (F_CPU / 1000000)) : 0;
+		outMax = maxCycles / (F_CPU / 1000000);
+	}
+};
+
+// Counters for the time from the motion callback to the response being on the leds
+// The lighting control polls the sensor pin and gives no edge time, so its polling delay before the callback is not included
+struct SMotionStats
+{
+	uint32_t	edges;			// The number of motion edges responded to
+	uint32_t	responses;		// The number of those whose response frame has been shown
+	uint32_t	lastUS;
+	uint32_t	maxUS;
+	uint64_t	totalUS;
+};
+
+// Counters for the frame pacing of the led output
+struct SFrameStats
+{
+	uint32_t	framesShown;	// The number of DMA transfers started
+	uint32_t	framesDropped;	// The number of times a frame was deferred because the previous DMA transfer was still running
+	uint32_t	maxUpdateUS;	// The worst case duration of Update()
+	uint32_t	idleTicks;		// The number of updates skipped because the output was static
+	uint64_t	startMS;		// The time the stats were last reset
+	uint64_t	windowStartMS;	// The start of the current frame rate window
+	uint32_t	windowFrames;	// framesShown at the start of the current frame rate window
+	uint32_t	windowFPS;		// The shown frame rate measured over the last complete window
+	uint32_t	peakFPS;		// The highest windowFPS since the stats were reset
+};
+
+// The kinds of telemetry record, which of the record fields are used depends on the kind
+enum
+{
+	eTelemetry_Frames,		// a = frames dropped because DMA was busy, b = frames shown, c = worst update us, all since the previous frames record
+	eTelemetry_Lux,			// b = the lux brightness and c = the lux curve intensity, both * 1000
+	eTelemetry_Motion,		// a = the motion sensor state
+	eTelemetry_MotionShown,	// c = the us from a motion callback to its response being on the leds
+	eTelemetry_Pattern,		// a = the view mode, b = the base pattern index or 0xFFFF for none
+};
+
+// A fixed size telemetry record, these are written to a ring on the hot path and packed into log messages later
+struct STelemetryRecord
+{
+	uint32_t	timeMS;
+	uint8_t		kind;
+	uint8_t		a;
+	uint16_t	b;
+	uint32_t	c;
+};
+
+// The holiday patterns are described by a palette and a list of runs, each run gives a palette color and the number of panels it covers
+// The runs repeat across the roof, the pattern is expanded once when it is selected, straight into the led output unless the frame buffer is needed
+
+struct SPatternRun
+{
+	uint8_t	paletteIndex;
+	uint8_t	panelCount;
+};
+
+// A pattern uploaded at run time, the descriptor is stored in a fixed slot in the settings so uploads never allocate
+// The descriptor is uploaded as the hex of these bytes, any bytes not given are zero
+struct SUserPatternDesc
+{
+	char		name[12];
+	uint8_t		startMonth;		// The first date the pattern is shown, 0 to only show it when cycling patterns
+	uint8_t		startDay;
+	uint8_t		dayCount;		// The number of days the pattern is shown for
+	uint8_t		scrollPeriod;	// The time in eUserScrollStepMS units to scroll the runs along one panel, 0 for a static pattern
+	uint8_t		paletteCount;
+	uint8_t		runCount;
+	uint8_t		palette[eUserPaletteMax][3];
+	SPatternRun	runs[eUserRunMax];
+};
+
+// The state the leds were last shown with, this is shown at boot until the clock and the lighting control are up
+struct SBootState
+{
+	uint8_t		patternIndex;	// The base pattern index, 0xFF for none
+	uint8_t		viewMode;
+	float		intensity;		// The resting intensity without motion or lux, 0 if the leds were off
+};
+
+struct SSettings
+{
+	SFloatPixel	defaultColor;
+	float		defaultIntensity;
+	float		activeIntensity;
+	float		minLux;
+	float		maxLux;
+	uint32_t	fadeTimeMS;		// The time to fade between the lowest and highest intensity, 0 to switch instantly
+	float		gamma;			// The output gamma, 1 for linear output
+	SFloatPixel	colorBalance;	// Per channel scale in the range 0 to 1 applied before gamma to correct the color of the panels
+	uint32_t	framePeriodUS;	// The time between rendered frames, 0 for eDefaultFramePeriodUS
+	uint8_t		dither;			// Non zero to enable temporal dithering of the output
+	uint32_t	powerBudgetMA;	// The most current the leds may draw, the brightness is scaled down to fit, 0 for no limit
+	uint32_t	channelMA;		// The current of one fully on led channel, 0 for eDefaultChannelMA
+	float		luxCurve[eLuxCurvePoints];	// The fraction of the default intensity at evenly spaced lux brightness values from dark to bright
+	float		luxDeadband;	// A lux brightness change smaller than this is ignored
+	float		luxHysteresis;	// The extra change needed when the lux brightness turns around so noise at a step does not flicker
+	uint8_t		luxSteps;		// The number of intensity steps the curve output is rounded to, 0 to not round
+	uint32_t	waveEntryLED;	// The led nearest the walkway entry, motion brightens the leds outwards from here
+	uint32_t	waveTimeMS;		// The time for the motion wave to reach the far end of the roof, 0 to brighten every led at once
+	SBootState	boot;			// Kept up to date as the leds change, not set by settings_set
+
+	SUserPatternDesc	userPatterns[eUserPatternSlots];	// A slot is free if its paletteCount is 0
+};
+
+enum
+{
+	eSettingType_Float,
+	eSettingType_UInt32,
+	eSettingType_UInt8,
+};
+
+// The flags for what needs to be updated after a setting changes
+enum
+{
+	eSettingApply_Frame = 1 << 0,		// The frame needs to be redrawn
+	eSettingApply_Gamma = 1 << 1,		// The gamma curve needs to be rebuilt
+	eSettingApply_Lux = 1 << 2,			// The lux range needs to be sent to the luminosity sensor
+	eSettingApply_LuxCurve = 1 << 3,	// The lux intensity needs to be evaluated again
+};
+
+// Describes a field in SSettings that can be set by name with settings_set
+struct SSettingDesc
+{
+	char const*	name;
+	uint8_t		type;
+	uint8_t		count;		// The number of comma separated values
+	uint8_t		apply;
+	uint16_t	offset;
+};
+
+SSettingDesc const	cSettingDescs[] =
+{
+	{"color",			eSettingType_Float,		3,	eSettingApply_Frame,	offsetof(SSettings, defaultColor)},
+	{"default",			eSettingType_Float,		1,	0,						offsetof(SSettings, defaultIntensity)},
+	{"active",			eSettingType_Float,		1,	0,						offsetof(SSettings, activeIntensity)},
+	{"minlux",			eSettingType_Float,		1,	eSettingApply_Lux,		offsetof(SSettings, minLux)},
+	{"maxlux",			eSettingType_Float,		1,	eSettingApply_Lux,		offsetof(SSettings, maxLux)},
+	{"fade",			eSettingType_UInt32,	1,	0,						offsetof(SSettings, fadeTimeMS)},
+	{"gamma",			eSettingType_Float,		1,	eSettingApply_Gamma,	offsetof(SSettings, gamma)},
+	{"balance",			eSettingType_Float,		3,	eSettingApply_Gamma,	offsetof(SSettings, colorBalance)},
+	{"period",			eSettingType_UInt32,	1,	0,						offsetof(SSettings, framePeriodUS)},
+	{"dither",			eSettingType_UInt8,		1,	eSettingApply_Frame,	offsetof(SSettings, dither)},
+	{"power",			eSettingType_UInt32,	1,	0,						offsetof(SSettings, powerBudgetMA)},
+	{"channelma",		eSettingType_UInt32,	1,	0,						offsetof(SSettings, channelMA)},
+	{"luxcurve",		eSettingType_Float,		eLuxCurvePoints,	eSettingApply_LuxCurve,	offsetof(SSettings, luxCurve)},
+	{"luxdeadband",		eSettingType_Float,		1,	eSettingApply_LuxCurve,	offsetof(SSettings, luxDeadband)},
+	{"luxhysteresis",	eSettingType_Float,		1,	eSettingApply_LuxCurve,	offsetof(SSettings, luxHysteresis)},
+	{"luxsteps",		eSettingType_UInt8,		1,	eSettingApply_LuxCurve,	offsetof(SSettings, luxSteps)},
+	{"waveentry",		eSettingType_UInt32,	1,	0,						offsetof(SSettings, waveEntryLED)},
+	{"wavetime",		eSettingType_UInt32,	1,	0,						offsetof(SSettings, waveTimeMS)},
+};
+
+// Write a quantized pixel to the led output, only a changed pixel is added to ioDirty and ioSum is kept as the sum of every channel
+inline void
+WriteOutputPixel(
+	SRGBPixel&			ioPixel,
+	int					inIndex,
+	SRGBPixel const&	inValue,
+	uint32_t&			ioSum,
+	SPixelSpan&			ioDirty)
+{
+	if(ioPixel.r == inValue.r && ioPixel.g == inValue.g && ioPixel.b == inValue.b)
+	{
+		return;
+	}
+
+	ioSum += (inValue.r + inValue.g + inValue.b) - (ioPixel.r + ioPixel.g + ioPixel.b);
+	ioPixel = inValue;
+	ioDirty.Add(inIndex);
+}
+
+// The pattern kernels below are templates on the stage their pixels are written to, each stage is inlined into the kernel loop
+// so the same kernel either fills the frame buffer or goes straight to the leds through the output tables in one pass
+
+// Writes pixels into the frame buffer
+struct SFrameBufferStage
+{
+	SPixel*	pixels;
+
+	inline void
+	Fill(
+		int				inStart,
+		int				inEnd,
+		SPixel const&	inPixel)
+	{
+		for(int itr = inStart; itr < inEnd; ++itr)
+		{
+			pixels[itr] = inPixel;
+		}
+	}
+};
+
+// Scales pixels through the output tables, which hold the intensity, color balance and gamma, and writes them to the led output
+struct SOutputStage
+{
+	uint16_t const	(*lut)[256];
+	SRGBPixel*		pixels;
+	uint32_t*		sum;
+	SPixelSpan*		dirty;
+
+	inline void
+	Fill(
+		int				inStart,
+		int				inEnd,
+		SPixel const&	inPixel)
+	{
+		SRGBPixel	value;
+
+		// A fill is one color so it is only scaled once
+		ScalePixel(inPixel, lut, value);
+		for(int itr = inStart; itr < inEnd; ++itr)
+		{
+			WriteOutputPixel(pixels[itr], itr, value, *sum, *dirty);
+		}
+	}
+};
+
+// Fill inPixels with the repeating runs of solid panels starting inOffset panels into the runs
+template<class TStage>
+inline void
+DrawPanelRuns(
+	SPixel const*		inPalette,
+	SPatternRun const*	inRuns,
+	int					inRunCount,
+	int					inOffset,
+	int					inPixels,
+	TStage&				ioStage)
+{
+	int	runItr = 0;
+	int	panelsLeft = inRuns[0].panelCount;
+
+	while(inOffset >= panelsLeft)
+	{
+		inOffset -= panelsLeft;
+		runItr = (runItr + 1) % inRunCount;
+		panelsLeft = inRuns[runItr].panelCount;
+	}
+	panelsLeft -= inOffset;
+
+	for(int pixelItr = 0; pixelItr < inPixels; runItr = (runItr + 1) % inRunCount, panelsLeft = inRuns[runItr].panelCount)
+	{
+		int	runEnd = pixelItr + panelsLeft * eLEDsPerPanel;
+
+		if(runEnd > inPixels)
+		{
+			runEnd = inPixels;
+		}
+
+		ioStage.Fill(pixelItr, runEnd, inPalette[inRuns[runItr].paletteIndex]);
+		pixelItr = runEnd;
+	}
+}
+
+// Patterns inherit from CBasePattern
+class CBasePattern
+{
+public:
+	
+	CBasePattern(
+		bool	inAddToList = true)
+	{
+		// Room is always left for the user pattern slots
+		if(inAddToList && gPatternCount < eMaxPatternCount - eUserPatternSlots)
+		{
+			gPatternList[gPatternCount++] = this;
+		}
+	}
+
+	// This does the actual drawing. must be defined by the derived class
+	// Only pixels that change need to be written, unless ioFrame.fullRedraw is set, and they must be added to ioFrame.dirty
+	virtual void
+	Draw(
+		SPatternFrame&	ioFrame,
+		int				inPixels,
+		SPixel*			inPixelMem) = 0;
+
+	virtual char const*
+	GetName(
+		void) = 0;
+
+	// Patterns with a fused kernel return true and have DrawOutput() called instead of Draw() when the frame buffer is not needed
+	virtual bool
+	CanDrawOutput(
+		void)
+	{
+		return false;
+	}
+
+	// Draw straight into the led output, the same rules as Draw() apply but the pixels go through ioOutput
+	virtual void
+	DrawOutput(
+		SPatternFrame&	ioFrame,
+		int				inPixels,
+		SOutputStage&	ioOutput)
+	{
+	}
+
+	// Animated patterns return true to have Draw() called every frame, static patterns are only drawn when a full redraw is needed so they cost nothing per frame
+	virtual bool
+	IsAnimated(
+		void)
+	{
+		return false;
+	}
+
+	// A pattern that keeps its place in gPatternList while it has nothing to draw returns false, it is skipped when picking patterns
+	virtual bool
+	IsEnabled(
+		void)
+	{
+		return true;
+	}
+};
+
+class CPalettePattern : public CBasePattern
+{
+public:
+
+	CPalettePattern(
+		char const*			inName,
+		SFloatPixel const*	inPalette,
+		SPatternRun const*	inRuns,
+		int					inRunCount)
+		:
+		CBasePattern(),
+		name(inName),
+		runs(inRuns),
+		runCount(inRunCount)
+	{
+		// The palette is converted once so the kernel only copies pixels
+		for(int itr = 0; itr < runCount; ++itr)
+		{
+			SFloatPixel const&	color = inPalette[runs[itr].paletteIndex];
+
+			SetPixelColor(palette[runs[itr].paletteIndex], color.r, color.g, color.b);
+		}
+	}
+
+	virtual void
+	Draw(
+		SPatternFrame&	ioFrame,
+		int				inPixels,
+		SPixel*			inPixelMem)
+	{
+		SFrameBufferStage	stage = {inPixelMem};
+
+		DrawPanelRuns(palette, runs, runCount, 0, inPixels, stage);
+		ioFrame.dirty.Add(0, inPixels);
+	}
+
+	virtual bool
+	CanDrawOutput(
+		void)
+	{
+		return true;
+	}
+
+	virtual void
+	DrawOutput(
+		SPatternFrame&	ioFrame,
+		int				inPixels,
+		SOutputStage&	ioOutput)
+	{
+		DrawPanelRuns(palette, runs, runCount, 0, inPixels, ioOutput);
+		ioFrame.dirty.Add(0, inPixels);
+	}
+
+	virtual char const*
+	GetName(
+		void)
+	{
+		return name;
+	}
+
+private:
+
+	char const*			name;
+	SPixel				palette[ePaletteMax];
+	SPatternRun const*	runs;
+	int					runCount;
+};
+
+static SFloatPixel const	cXMasPalette[] = {{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}};
+static SPatternRun const	cXMasRuns[] = {{0, 1}, {1, 1}};
+static CPalettePattern		gXMasPattern("Christmas", cXMasPalette, cXMasRuns, sizeof(cXMasRuns) / sizeof(cXMasRuns[0]));
+
+static SFloatPixel const	cValintinePalette[] = {{1.0f, 0.0f, 0.0f}};
+static SPatternRun const	cValintineRuns[] = {{0, 1}};
+static CPalettePattern		gValintinePattern("Valentine's Day", cValintinePalette, cValintineRuns, sizeof(cValintineRuns) / sizeof(cValintineRuns[0]));
+
+static SFloatPixel const	cJuly4Palette[] = {{1.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 1.0f}};
+static SPatternRun const	cJuly4Runs[] = {{0, 1}, {1, 1}, {2, 1}};
+static CPalettePattern		gJuly4Pattern("4th Of July", cJuly4Palette, cJuly4Runs, sizeof(cJuly4Runs) / sizeof(cJuly4Runs[0]));
+
+static SFloatPixel const	cHalloweenPalette[] = {{1.0f, 0.65f, 0.0f}, {0.5f, 0.0f, 0.5f}};
+static SPatternRun const	cHalloweenRuns[] = {{0, 1}, {1, 1}};
+static CPalettePattern		gHalloweenPattern("Halloween", cHalloweenPalette, cHalloweenRuns, sizeof(cHalloweenRuns) / sizeof(cHalloweenRuns[0]));
+
+static SFloatPixel const	cStPattyPalette[] = {{0.0f, 1.0f, 0.0f}};
+static SPatternRun const	cStPattyRuns[] = {{0, 1}};
+static CPalettePattern		gStPattyPattern("St. Patty's Day", cStPattyPalette, cStPattyRuns, sizeof(cStPattyRuns) / sizeof(cStPattyRuns[0]));
+
+static SFloatPixel const	cEasterPalette[] = {{1.0f, 1.0f, 0.0f}, {0.5f, 0.0f, 0.5f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {1.0f, 0.41f, 0.71f}, {1.0f, 0.65f, 0.0f}};
+static SPatternRun const	cEasterRuns[] = {{0, 1}, {1, 1}, {2, 1}, {3, 1}, {4, 1}, {5, 1}, {6, 1}};
+static CPalettePattern		gEasterPattern("Easter", cEasterPalette, cEasterRuns, sizeof(cEasterRuns) / sizeof(cEasterRuns[0]));
+
+// A pattern described by a SUserPatternDesc in the settings, each slot has a fixed place in gPatternList and is disabled while it holds no descriptor
+class CUserPattern : public CBasePattern
+{
+public:
+
+	CUserPattern(
+		)
+		:
+		CBasePattern(false)
+	{
+		desc = NULL;
+		lastOffset = -1;
+	}
+
+	// Return true if the descriptor can be drawn
+	static bool
+	IsValid(
+		SUserPatternDesc const&	inDesc)
+	{
+		if(inDesc.paletteCount == 0 || inDesc.paletteCount > eUserPaletteMax || inDesc.runCount == 0 || inDesc.runCount > eUserRunMax
+			|| inDesc.startMonth > 12 || (inDesc.startMonth != 0 && (inDesc.startDay == 0 || inDesc.startDay > 31)))
+		{
+			return false;
+		}
+
+		for(int itr = 0; itr < inDesc.runCount; ++itr)
+		{
+			if(inDesc.runs[itr].paletteIndex >= inDesc.paletteCount || inDesc.runs[itr].panelCount == 0)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// Use the given descriptor, NULL when the slot is freed
+	void
+	Load(
+		SUserPatternDesc const*	inDesc)
+	{
+		desc = inDesc;
+		totalPanels = 0;
+		lastOffset = -1;
+
+		if(desc == NULL)
+		{
+			return;
+		}
+
+		for(int itr = 0; itr < desc->paletteCount; ++itr)
+		{
+			SetPixelRGB(palette[itr], desc->palette[itr][0], desc->palette[itr][1], desc->palette[itr][2]);
+		}
+
+		for(int itr = 0; itr < desc->runCount; ++itr)
+		{
+			totalPanels += desc->runs[itr].panelCount;
+		}
+	}
+
+	SUserPatternDesc const*
+	GetDesc(
+		void)
+	{
+		return desc;
+	}
+
+	virtual void
+	Draw(
+		SPatternFrame&	ioFrame,
+		int				inPixels,
+		SPixel*			inPixelMem)
+	{
+		SFrameBufferStage	stage = {inPixelMem};
+
+		DrawScrolled(ioFrame, inPixels, stage);
+	}
+
+	virtual bool
+	CanDrawOutput(
+		void)
+	{
+		return desc != NULL;
+	}
+
+	virtual void
+	DrawOutput(
+		SPatternFrame&	ioFrame,
+		int				inPixels,
+		SOutputStage&	ioOutput)
+	{
+		DrawScrolled(ioFrame, inPixels, ioOutput);
+	}
+
+	virtual char const*
+	GetName(
+		void)
+	{
+		return desc != NULL ? desc->name : "Unused";
+	}
+
+	virtual bool
+	IsAnimated(
+		void)
+	{
+		return desc != NULL && desc->scrollPeriod != 0;
+	}
+
+	virtual bool
+	IsEnabled(
+		void)
+	{
+		return desc != NULL;
+	}
+
+private:
+
+	// Draw the runs at the current scroll offset, nothing is drawn if the offset has not changed since the last frame
+	template<class TStage>
+	void
+	DrawScrolled(
+		SPatternFrame&	ioFrame,
+		int				inPixels,
+		TStage&			ioStage)
+	{
+		if(desc == NULL)
+		{
+			return;
+		}
+
+		int	offset = desc->scrollPeriod != 0 ? int(ioFrame.timeMS / (desc->scrollPeriod * eUserScrollStepMS) % totalPanels) : 0;
+
+		if(ioFrame.fullRedraw == false && offset == lastOffset)
+		{
+			return;
+		}
+		lastOffset = offset;
+
+		DrawPanelRuns(palette, desc->runs, desc->runCount, offset, inPixels, ioStage);
+		ioFrame.dirty.Add(0, inPixels);
+	}
+
+	SUserPatternDesc const*	desc;
+	SPixel					palette[eUserPaletteMax];
+	int						totalPanels;
+	int						lastOffset;
+};
+
+static CUserPattern	gUserPatterns[eUserPatternSlots];
+
+// The animated patterns are defined below, their output must only depend on the frame time so any frame can be redrawn from scratch
+
+// Bands of a foreground color move along the roof over a background color
+class CChasePattern : public CBasePattern
+{
+public:
+
+	CChasePattern(
+		)
+		:
+		CBasePattern()
+	{
+		SetPixelRGB(foreground, 0xFF, 0xFF, 0xFF);
+		SetPixelRGB(background, 0xFF, 0x00, 0x00);
+		lastOffset = 0;
+	}
+
+	virtual void
+	Draw(
+		SPatternFrame&	ioFrame,
+		int				inPixels,
+		SPixel*			inPixelMem)
+	{
+		int	offset = int((uint64_t(ioFrame.timeMS) * eChaseLEDsPerSec / 1000) % eChasePeriod);
+		int	step = (offset - lastOffset + eChasePeriod) % eChasePeriod;
+
+		if(ioFrame.fullRedraw || step > eChaseWidth || step > eChasePeriod - eChaseWidth)
+		{
+			for(int itr = 0; itr < inPixels; ++itr)
+			{
+				inPixelMem[itr] = IsLit(itr, offset) ? foreground : background;
+			}
+			ioFrame.dirty.Add(0, inPixels);
+		}
+		else if(step > 0)
+		{
+			// Only the leading and trailing edge of each band change, these are the step pixels before each band's end and before each band's start
+			for(int bandStart = offset - eChasePeriod; bandStart - step < inPixels; bandStart += eChasePeriod)
+			{
+				DrawRange(bandStart + eChaseWidth - step, step, offset, inPixels, inPixelMem, ioFrame.dirty);
+				DrawRange(bandStart - step, step, offset, inPixels, inPixelMem, ioFrame.dirty);
+			}
+		}
+
+		lastOffset = offset;
+	}
+
+	virtual char const*
+	GetName(
+		void)
+	{
+		return "Chase";
+	}
+
+	virtual bool
+	IsAnimated(
+		void)
+	{
+		return true;
+	}
+
+private:
+
+	enum
+	{
+		eChaseWidth = 8,		// The number of lit leds in each band
+		eChasePeriod = 24,		// The distance in leds between the start of each band
+		eChaseLEDsPerSec = 20,	// The speed the bands move to the right
+	};
+
+	bool
+	IsLit(
+		int	inIndex,
+		int	inOffset)
+	{
+		return (inIndex - inOffset + eChasePeriod * 2) % eChasePeriod < eChaseWidth;
+	}
+
+	void
+	DrawRange(
+		int			inStart,
+		int			inCount,
+		int			inOffset,
+		int			inPixels,
+		SPixel*		inPixelMem,
+		SPixelSpan&	ioDirty)
+	{
+		int	end = inStart + inCount;
+
+		if(inStart < 0)
+		{
+			inStart = 0;
+		}
+
+		if(end > inPixels)
+		{
+			end = inPixels;
+		}
+
+		for(int itr = inStart; itr < end; ++itr)
+		{
+			inPixelMem[itr] = IsLit(itr, inOffset) ? foreground : background;
+		}
+
+		if(inStart < end)
+		{
+			ioDirty.Add(inStart, end);
+		}
+	}
+
+	SPixel	foreground;
+	SPixel	background;
+	int		lastOffset;
+};
+static CChasePattern	gChasePattern;
+
+// A fixed number of twinkle slots each brighten and fade one pseudo randomly chosen led over a background color
+class CTwinklePattern : public CBasePattern
+{
+public:
+
+	CTwinklePattern(
+		)
+		:
+		CBasePattern()
+	{
+		SetPixelRGB(background, 0x00, 0x00, 0x60);
+		SetPixelRGB(sparkle, 0xFF, 0xFF, 0xFF);
+		memset(slotLED, 0, sizeof(slotLED));
+	}
+
+	virtual void
+	Draw(
+		SPatternFrame&	ioFrame,
+		int				inPixels,
+		SPixel*			inPixelMem)
+	{
+		int		newSlotLED[eTwinkleSlots];
+		uint8_t	newSlotLevel[eTwinkleSlots];
+
+		for(int itr = 0; itr < eTwinkleSlots; ++itr)
+		{
+			// Stagger the slots so they do not all pick a new led at the same time
+			uint32_t	slotTimeMS = ioFrame.timeMS + uint32_t(itr) * (eTwinklePeriodMS / eTwinkleSlots);
+			uint32_t	cycle = slotTimeMS / eTwinklePeriodMS;
+			uint32_t	phase = slotTimeMS % eTwinklePeriodMS;
+
+			newSlotLED[itr] = int(Hash(cycle * eTwinkleSlots + itr) % uint32_t(inPixels));
+			newSlotLevel[itr] = uint8_t((phase < eTwinklePeriodMS / 2 ? phase : eTwinklePeriodMS - phase) * 510 / eTwinklePeriodMS);
+		}
+
+		if(ioFrame.fullRedraw)
+		{
+			for(int itr = 0; itr < inPixels; ++itr)
+			{
+				inPixelMem[itr] = background;
+			}
+			ioFrame.dirty.Add(0, inPixels);
+		}
+		else
+		{
+			// Restore every led a slot is leaving before drawing any slot so overlapping slots draw the same as a full redraw
+			for(int itr = 0; itr < eTwinkleSlots; ++itr)
+			{
+				if(slotLED[itr] != newSlotLED[itr] && slotLED[itr] < inPixels)
+				{
+					inPixelMem[slotLED[itr]] = background;
+					ioFrame.dirty.Add(slotLED[itr]);
+				}
+			}
+		}
+
+		for(int itr = 0; itr < eTwinkleSlots; ++itr)
+		{
+			SPixel	pixel;
+
+			BlendPixel(background, sparkle, newSlotLevel[itr], pixel);
+			if(PixelsEqual(pixel, inPixelMem[newSlotLED[itr]]) == false)
+			{
+				inPixelMem[newSlotLED[itr]] = pixel;
+				ioFrame.dirty.Add(newSlotLED[itr]);
+			}
+			slotLED[itr] = newSlotLED[itr];
+		}
+	}
+
+	virtual char const*
+	GetName(
+		void)
+	{
+		return "Twinkle";
+	}
+
+	virtual bool
+	IsAnimated(
+		void)
+	{
+		return true;
+	}
+
+private:
+
+	enum
+	{
+		eTwinkleSlots = 16,			// The number of leds twinkling at any time
+		eTwinklePeriodMS = 1600,	// The time for one led to brighten and fade
+	};
+
+	SPixel	background;
+	SPixel	sparkle;
+	int		slotLED[eTwinkleSlots];
+};
+static CTwinklePattern	gTwinklePattern;
+
+// Each panel shows a color from a color wheel spread across the roof and the wheel slowly rotates
+class CColorWheelPattern : public CBasePattern
+{
+public:
+
+	CColorWheelPattern(
+		)
+		:
+		CBasePattern()
+	{
+		memset(panelHue, 0, sizeof(panelHue));
+	}
+
+	virtual void
+	Draw(
+		SPatternFrame&	ioFrame,
+		int				inPixels,
+		SPixel*			inPixelMem)
+	{
+		int	panelCount = (inPixels + eLEDsPerPanel - 1) / eLEDsPerPanel;
+		int	rotation = int((uint64_t(ioFrame.timeMS) * 256 / eWheelRotationMS) & 0xFF);
+
+		for(int panelItr = 0; panelItr < panelCount && panelItr < ePanelCount; ++panelItr)
+		{
+			uint8_t	hue = uint8_t(rotation + panelItr * 256 / panelCount);
+
+			// A panel is only redrawn when its hue has moved to the next step
+			if(ioFrame.fullRedraw == false && hue == panelHue[panelItr])
+			{
+				continue;
+			}
+
+			SPixel	pixel;
+			int		start = panelItr * eLEDsPerPanel;
+			int		end = start + eLEDsPerPanel < inPixels ? start + eLEDsPerPanel : inPixels;
+
+			GetWheelColor(hue, pixel);
+			for(int itr = start; itr < end; ++itr)
+			{
+				inPixelMem[itr] = pixel;
+			}
+			ioFrame.dirty.Add(start, end);
+			panelHue[panelItr] = hue;
+		}
+	}
+
+	virtual char const*
+	GetName(
+		void)
+	{
+		return "Color Wheel";
+	}
+
+	virtual bool
+	IsAnimated(
+		void)
+	{
+		return true;
+	}
+
+private:
+
+	enum
+	{
+		eWheelRotationMS = 30000,	// The time for one full rotation of the wheel
+	};
+
+	// Map a hue in the range 0 to 255 onto the red -> green -> blue -> red color wheel
+	static void
+	GetWheelColor(
+		uint8_t	inHue,
+		SPixel&	outPixel)
+	{
+		uint8_t	ramp = uint8_t((inHue % 85) * 3);
+
+		if(inHue < 85)
+		{
+			SetPixelRGB(outPixel, 255 - ramp, ramp, 0);
+		}
+		else if(inHue < 170)
+		{
+			SetPixelRGB(outPixel, 0, 255 - ramp, ramp);
+		}
+		else
+		{
+			SetPixelRGB(outPixel, ramp, 0, 255 - ramp);
+		}
+	}
+
+	uint8_t	panelHue[ePanelCount];
+};
+static CColorWheelPattern	gColorWheelPattern;
+
+static_assert(eBuiltInPatternCount + eUserPatternSlots <= eMaxPatternCount, "gPatternList has no room for the user pattern slots");
+
+// Get the pattern at inIndex in gPatternList, NULL if there is none or it is disabled
+inline CBasePattern*
+GetEnabledPattern(
+	int	inIndex)
+{
+	return inIndex >= 0 && inIndex < gPatternCount && gPatternList[inIndex]->IsEnabled() ? gPatternList[inIndex] : NULL;
+}
+
+// A layer composited over the base pattern, the layers are a fixed pool in the module so adding one never allocates
+struct SLayer
+{
+	CLayerEffect*	effect;			// NULL if the slot is free
+	uint8_t			blend;
+	SPixel			color;
+	int				firstLED;		// The range of leds the layer can cover
+	int				ledCount;
+	uint32_t		periodMS;		// The time of one cycle of the effect
+	uint32_t		durationMS;		// The layer is removed once it has been shown this long, 0 to keep it until it is removed
+	uint32_t		param;			// Effect specific, the band width of a sweep or the density of a sparkle
+	uint32_t		startMS;
+	uint32_t		elapsedMS;		// The time since startMS of the frame being composited
+	int				state;			// Set by the effect in Prepare() for use in GetCoverage()
+	SPixelSpan		span;			// The leds the layer covers in the frame being composited, an empty span once a freed layer has been cleared
+};
+
+// Layer effects inherit from CLayerEffect, like the patterns their output must only depend on the layer and its elapsed time
+// Only the leds in the span found by Prepare() are composited so the cost of a layer depends on its size and not on the led count
+class CLayerEffect
+{
+public:
+
+	CLayerEffect(
+		)
+	{
+		gEffectList[gEffectCount++] = this;
+	}
+
+	virtual char const*
+	GetName(
+		void) = 0;
+
+	// Set ioLayer.span to the leds the layer covers at ioLayer.elapsedMS and anything GetCoverage() needs in ioLayer.state
+	virtual void
+	Prepare(
+		SLayer&	ioLayer)
+	{
+		ioLayer.span.start = ioLayer.firstLED;
+		ioLayer.span.end = ioLayer.firstLED + ioLayer.ledCount;
+	}
+
+	// Return how much of the layer shows at led inIndex (0 is none, 255 is all), inIndex is always in the span
+	virtual uint8_t
+	GetCoverage(
+		SLayer const&	inLayer,
+		int				inIndex) = 0;
+};
+
+// A band of the layer color with a fading tail sweeps across the range once per period
+class CSweepEffect : public CLayerEffect
+{
+public:
+
+	virtual char const*
+	GetName(
+		void)
+	{
+		return "sweep";
+	}
+
+	virtual void
+	Prepare(
+		SLayer&	ioLayer)
+	{
+		int	width = GetWidth(ioLayer);
+		int	head = int(uint64_t(ioLayer.elapsedMS % ioLayer.periodMS) * (ioLayer.ledCount + width) / ioLayer.periodMS);
+
+		ioLayer.state = ioLayer.firstLED + head - width;
+		ioLayer.span.start = ioLayer.state > ioLayer.firstLED ? ioLayer.state : ioLayer.firstLED;
+		ioLayer.span.end = head < ioLayer.ledCount ? ioLayer.firstLED + head : ioLayer.firstLED + ioLayer.ledCount;
+	}
+
+	virtual uint8_t
+	GetCoverage(
+		SLayer const&	inLayer,
+		int				inIndex)
+	{
+		return uint8_t((inIndex - inLayer.state + 1) * 255 / GetWidth(inLayer));
+	}
+
+private:
+
+	static int
+	GetWidth(
+		SLayer const&	inLayer)
+	{
+		return inLayer.param != 0 ? int(inLayer.param) : eLEDsPerPanel;
+	}
+};
+static CSweepEffect	gSweepEffect;
+
+// Random leds in the range brighten and fade, each once per period at its own phase, param is the chance of a led lighting in a period out of 255
+class CSparkleEffect : public CLayerEffect
+{
+public:
+
+	virtual char const*
+	GetName(
+		void)
+	{
+		return "sparkle";
+	}
+
+	virtual uint8_t
+	GetCoverage(
+		SLayer const&	inLayer,
+		int				inIndex)
+	{
+		uint32_t	timeMS = inLayer.elapsedMS + Hash(uint32_t(inIndex)) % inLayer.periodMS;
+		uint32_t	cycle = timeMS / inLayer.periodMS;
+		uint32_t	phase = timeMS % inLayer.periodMS;
+		uint32_t	density = inLayer.param != 0 ? inLayer.param : 16;
+
+		if((Hash(cycle * eLEDCount + uint32_t(inIndex)) & 0xFF) >= density)
+		{
+			return 0;
+		}
+
+		return uint8_t((phase < inLayer.periodMS / 2 ? phase : inLayer.periodMS - phase) * 510 / inLayer.periodMS);
+	}
+};
+static CSparkleEffect	gSparkleEffect;
+
+// The whole range flashes to the layer color at the start of each period and fades out over it
+class CFlashEffect : public CLayerEffect
+{
+public:
+
+	virtual char const*
+	GetName(
+		void)
+	{
+		return "flash";
+	}
+
+	virtual void
+	Prepare(
+		SLayer&	ioLayer)
+	{
+		CLayerEffect::Prepare(ioLayer);
+		ioLayer.state = 255 - int(uint64_t(ioLayer.elapsedMS % ioLayer.periodMS) * 255 / ioLayer.periodMS);
+	}
+
+	virtual uint8_t
+	GetCoverage(
+		SLayer const&	inLayer,
+		int				inIndex)
+	{
+		return uint8_t(inLayer.state);
+	}
+};
+static CFlashEffect	gFlashEffect;
+
+// Covers the leds a wave has not reached yet, the wave spreads both ways from the led in param and reaches the far end of the range in one period
+// With a multiply blend this holds back the leds far from the entry while the ones near it brighten first
+class CWaveEffect : public CLayerEffect
+{
+public:
+
+	virtual char const*
+	GetName(
+		void)
+	{
+		return "wave";
+	}
+
+	virtual void
+	Prepare(
+		SLayer&	ioLayer)
+	{
+		int	entry = int(ioLayer.param);
+		int	left = entry - ioLayer.firstLED;
+		int	right = ioLayer.firstLED + ioLayer.ledCount - 1 - entry;
+		int	farthest = left > right ? left : right;
+
+		// The front starts one ramp past the entry so the entry is fully lit in the first frame
+		CLayerEffect::Prepare(ioLayer);
+		ioLayer.state = eWaveRampLEDs + int(uint64_t(ioLayer.elapsedMS) * farthest / ioLayer.periodMS);
+	}
+
+	virtual uint8_t
+	GetCoverage(
+		SLayer const&	inLayer,
+		int				inIndex)
+	{
+		int	distance = inIndex > int(inLayer.param) ? inIndex - int(inLayer.param) : int(inLayer.param) - inIndex;
+
+		if(distance >= inLayer.state)
+		{
+			return 255;
+		}
+
+		if(distance <= inLayer.state - eWaveRampLEDs)
+		{
+			return 0;
+		}
+
+		return uint8_t((distance - (inLayer.state - eWaveRampLEDs)) * 255 / eWaveRampLEDs);
+	}
+
+private:
+
+	enum
+	{
+		eWaveRampLEDs = eLEDsPerPanel,	// The width of the soft edge of the wave front
+	};
+};
+static CWaveEffect	gWaveEffect;
+
+// Counters for pixel packets streamed from a PC
+struct SStreamStats
+{
+	uint32_t	packetsReceived;
+	uint32_t	packetsLost;		// Found from gaps in the packet sequence numbers
+	uint32_t	framesReceived;
+	uint32_t	packetsDropped;		// Packets that were not valid or were deltas without a valid previous frame
+	uint32_t	bytesReceived;		// The bytes received, this is the throughput of the link
+	uint32_t	totalLatencyMS;		// The sum of the latency of each packet over the fastest packet seen
+	uint32_t	maxLatencyMS;
+	int32_t		minClockOffsetMS;	// The smallest difference between the local time and the sender time, the fastest path through the link
+	uint64_t	startMS;
+	uint8_t		nextSequence;
+};
+
+// The header at the start of a sequence file, it is followed by frameCount frames of ledCount 8 bit rgb leds in left to right order
+struct SSequenceHeader
+{
+	char		magic[4];		// "FHSQ"
+	uint16_t	ledCount;
+	uint16_t	framePeriodMS;
+	uint32_t	frameCount;
+	uint32_t	reserved;
+};
+
+// Plays a sequence file from the sd card through a small ring of prefetched frames so sequences can be any length
+// Frames are plain rgb so any frame can be read without the ones before it, this keeps seeking to a wall clock time a single file seek
+class CSequencePlayer
+{
+public:
+
+	CSequencePlayer(
+		)
+	{
+		seekCount = 0;
+		readErrors = 0;
+		frameCount = 0;
+		Reset(0);
+	}
+
+	bool
+	Open(
+		char const*	inName)
+	{
+		Close();
+
+		file = SD.open(inName, FILE_READ);
+		if(!file)
+		{
+			return false;
+		}
+
+		SSequenceHeader	header;
+		if(file.read(&header, sizeof(header)) != sizeof(header) || memcmp(header.magic, "FHSQ", 4) != 0 || header.ledCount != eLEDCount
+			|| header.framePeriodMS == 0 || header.frameCount == 0 || file.size() < sizeof(header) + header.frameCount * eFrameSize)
+		{
+			file.close();
+			return false;
+		}
+
+		framePeriodMS = header.framePeriodMS;
+		frameCount = header.frameCount;
+		filePos = sizeof(header);
+		Reset(0);
+
+		return true;
+	}
+
+	void
+	Close(
+		void)
+	{
+		if(frameCount > 0)
+		{
+			file.close();
+		}
+		frameCount = 0;
+	}
+
+	bool
+	IsOpen(
+		void)
+	{
+		return frameCount > 0;
+	}
+
+	uint32_t
+	GetFramePeriodMS(
+		void)
+	{
+		return framePeriodMS;
+	}
+
+	uint32_t
+	GetFrameCount(
+		void)
+	{
+		return frameCount;
+	}
+
+	// Read at most one chunk toward filling the prefetch ring, this is called every update tick so a read never blocks the loop for long
+	void
+	Fill(
+		void)
+	{
+		if(frameCount == 0)
+		{
+			return;
+		}
+
+		int	fillItr = (headBuffer + bufferCount - 1) % eSequenceBufferCount;
+
+		if(bufferCount == 0 || fillBytes == eFrameSize)
+		{
+			if(bufferCount == eSequenceBufferCount)
+			{
+				return;
+			}
+
+			// Start reading the frame after the last buffered one
+			fillItr = (headBuffer + bufferCount) % eSequenceBufferCount;
+			fillBytes = 0;
+			++bufferCount;
+		}
+
+		uint32_t	frame = (headFrame + bufferCount - 1) % frameCount;
+		uint32_t	readPos = sizeof(SSequenceHeader) + frame * eFrameSize + fillBytes;
+
+		if(readPos != filePos)
+		{
+			++seekCount;
+			if(file.seek(readPos) == false)
+			{
+				++readErrors;
+				return;
+			}
+			filePos = readPos;
+		}
+
+		int	readBytes = eFrameSize - fillBytes < eSequenceReadChunk ? eFrameSize - fillBytes : eSequenceReadChunk;
+		int	result = file.read(buffers[fillItr] + fillBytes, readBytes);
+
+		if(result != readBytes)
+		{
+			// Seek on the next try in case the file position is now unknown
+			++readErrors;
+			filePos = 0xFFFFFFFF;
+			return;
+		}
+
+		fillBytes += readBytes;
+		filePos += readBytes;
+	}
+
+	// Return the given frame if it has been read, older frames are dropped
+	// If the reads have fallen behind the ring skips ahead to its newest complete frame and outFrame is set to that frame, the ring only restarts at the given frame if it is further ahead than the ring can hold or behind it
+	uint8_t const*
+	GetFrame(
+		uint32_t	inFrame,
+		uint32_t&	outFrame)
+	{
+		if(frameCount == 0)
+		{
+			return NULL;
+		}
+
+		uint32_t	distance = (inFrame + frameCount - headFrame) % frameCount;
+
+		if(distance >= uint32_t(bufferCount))
+		{
+			int	completeCount = bufferCount > 0 && fillBytes < eFrameSize ? bufferCount - 1 : bufferCount;
+
+			if(completeCount == 0 || distance >= uint32_t(bufferCount + eSequenceBufferCount))
+			{
+				Reset(inFrame);
+				return NULL;
+			}
+
+			distance = completeCount - 1;
+		}
+
+		headBuffer = (headBuffer + distance) % eSequenceBufferCount;
+		headFrame = (headFrame + distance) % frameCount;
+		bufferCount -= distance;
+
+		if(bufferCount == 1 && fillBytes < eFrameSize)
+		{
+			return NULL;
+		}
+
+		outFrame = headFrame;
+
+		return buffers[headBuffer];
+	}
+
+	uint32_t	seekCount;
+	uint32_t	readErrors;
+
+private:
+
+	enum
+	{
+		eFrameSize = eLEDCount * 3,
+	};
+
+	void
+	Reset(
+		uint32_t	inFrame)
+	{
+		headFrame = inFrame;
+		headBuffer = 0;
+		bufferCount = 0;
+		fillBytes = 0;
+	}
+
+	File		file;
+	uint32_t	frameCount;
+	uint32_t	framePeriodMS;
+	uint32_t	filePos;
+
+	uint8_t		buffers[eSequenceBufferCount][eFrameSize];
+	uint32_t	headFrame;		// The frame in buffers[headBuffer]
+	int			headBuffer;
+	int			bufferCount;	// The number of buffers holding frames, the last one is still being read if fillBytes is less than a frame
+	int			fillBytes;
+};
+
+// A run of days in the holiday calendar that all show the same pattern, the run ends at the start of the next one
+struct SHolidayRange
+{
+	uint16_t		startDay;		// The zero based day of the year the pattern starts
+	CBasePattern*	pattern;
+};
+
+int
+GetDaysInMonth(
+	int	inYear,
+	int	inMonth)
+{
+	static uint8_t const	cDaysInMonth[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+	if(inMonth == 2 && (inYear % 4) == 0 && ((inYear % 100) != 0 || (inYear % 400) == 0))
+	{
+		return 29;
+	}
+
+	return cDaysInMonth[inMonth - 1];
+}
+
+// Get the zero based day of the year given a one based month and day
+int
+GetDayOfYear(
+	int	inYear,
+	int	inMonth,
+	int	inDay)
+{
+	int	result = inDay - 1;
+
+	for(int itr = 1; itr < inMonth; ++itr)
+	{
+		result += GetDaysInMonth(inYear, itr);
+	}
+
+	return result;
+}
+
+// The module state that rendering frames outside of the update loop changes, a benchmark saves it first and puts it back after
+struct SRenderState
+{
+	uint8_t			viewMode;
+	CBasePattern*	basePattern;
+	float			currentIntensity;
+	float			testPatternValue;
+	uint64_t		cyclePatternTimeMS;
+	int				cyclePatternCount;
+	uint32_t		frameTimeUS;
+	uint32_t		frameDueUS;
+	uint32_t		lastPatternTimeMS;
+	uint32_t		patternTimeOffsetMS;
+	int				timeOfDay;
+	bool			motionSensorTriggered;
+	bool			syncActive;
+	bool			bootStateShown;
+	ILuminosity*	luminosityInterface;
+	uint16_t		powerLimitScale;
+	uint16_t		rawPowerScale;
+	uint8_t			dither;
+	uint32_t		powerBudgetMA;
+	uint32_t		fadeTimeMS;
+	SLayer			layers[eMaxLayers];
+	SPixelSpan		layerDirty[eMaxLayers];
+	int				activeLayerCount;
+};
+
+// This defines our main module
+class COutdoorLightingModule : public CModule, public IRealTimeHandler, public ISunRiseAndSetEventHandler, public IDigitalIOEventHandler, public ICmdHandler, public IInternetHandler, public IOutdoorLightingInterface
+{
+public:
+
+	MModule_Declaration(COutdoorLightingModule)
+
+	// The host test in HostTest renders and times frames through the private members
+	friend class CHostTest;
+
+private:
+	
+	COutdoorLightingModule(
+		)
+		:
+		CModule(
+			sizeof(SSettings),
+			eSettingsVersion,
+			&settings,
+			eUpdateTickUS),
+		leds(eLEDsPerStrip, gLEDDisplayMemory, gLEDDrawingMemory, WS2811_RGB)
+	{
+		// The user pattern slots follow the built in patterns so every pattern keeps its index as slots are used and freed
+		for(int itr = 0; itr < eUserPatternSlots; ++itr)
+		{
+			gPatternList[gPatternCount++] = &gUserPatterns[itr];
+		}
+
+		viewMode = 0;
+		memset(frameBuffer, 0, sizeof(frameBuffer));
+		memset(outputFrame, 0, sizeof(outputFrame));
+		basePattern = NULL;
+		drawnPattern = NULL;
+		fusedPattern = NULL;
+		memset(layers, 0, sizeof(layers));
+		for(int itr = 0; itr < eMaxLayers; ++itr)
+		{
+			layers[itr].span.Clear();
+			layerDirty[itr].Clear();
+		}
+		activeLayerCount = 0;
+		lastPatternTimeMS = 0;
+		frameBufferValid = false;
+		outputScale = eInvalidScale;
+		outputSum = 0;
+		powerLimitScale = 256;
+		rawPowerScale = 256;
+		currentIntensity = 0.0f;
+
+		// Defaults for every setting, these are replaced by the values saved in eeprom unless it was written by another settings version
+		settings.defaultColor.r = 1.0f;
+		settings.defaultColor.g = 0.6f;
+		settings.defaultColor.b = 0.3f;
+		settings.defaultIntensity = 0.3f;
+		settings.activeIntensity = 1.0f;
+		settings.minLux = 0.0f;
+		settings.maxLux = 1000.0f;
+		settings.fadeTimeMS = 1000;
+		settings.framePeriodUS = 0;
+		settings.dither = 0;
+		settings.powerBudgetMA = 0;
+		settings.channelMA = 0;
+		settings.waveEntryLED = 0;
+		settings.waveTimeMS = 0;
+		settings.gamma = 1.0f;
+		settings.colorBalance.r = 1.0f;
+		settings.colorBalance.g = 1.0f;
+		settings.colorBalance.b = 1.0f;
+		memset(settings.userPatterns, 0, sizeof(settings.userPatterns));
+
+		// The default lux curve dims linearly from the default intensity in the dark to off in daylight
+		for(int itr = 0; itr < eLuxCurvePoints; ++itr)
+		{
+			settings.luxCurve[itr] = 1.0f - float(itr) / float(eLuxCurvePoints - 1);
+		}
+		settings.luxDeadband = 0.02f;
+		settings.luxHysteresis = 0.02f;
+		settings.luxSteps = 32;
+		settings.boot.patternIndex = 0xFF;
+		settings.boot.viewMode = eViewMode_Normal;
+		settings.boot.intensity = 0.0f;
+		bootStateShown = false;
+		bootOverride = false;
+		bootTimeValidMS = 0;
+		bootFrameUS = 0;
+		luxValid = false;
+		luxSample = 0.0f;
+		luxBrightness = 0.0f;
+		luxDirection = 0;
+		luxIntensity = 0.0f;
+		outputDirty.Clear();
+		showPending = false;
+		memset(&frameStats, 0, sizeof(frameStats));
+		memset(ditherError, 0, sizeof(ditherError));
+		memset(perfRing, 0, sizeof(perfRing));
+		memset(perfFrame, 0, sizeof(perfFrame));
+		updateExitCycles = 0;
+		statusPageValid = false;
+		statusPageHTMLLen = 0;
+		statusPageJSONLen = 0;
+		settingsDirty = false;
+		settingsChangedMS = 0;
+		holidayRangeCount = 0;
+		holidayTableYear = 0;
+		nextPatternChangeEpoch = 0xFFFFFFFF;
+		calendarCheckMS = 0;
+		streamDirty.Clear();
+		streamLastPacketMS = 0;
+		memset(&streamStats, 0, sizeof(streamStats));
+		streamBaseValid = false;
+		streamFrameLoss = false;
+		syncActive = false;
+		syncIntensity = 0.0f;
+		patternTimeOffsetMS = 0;
+		syncWindowOffsetMS = 0;
+		syncWindowStartMS = 0;
+		syncLastMS = 0;
+		syncTargetOffsetMS = 0;
+		syncSlewMS = 0;
+		sdPresent = false;
+		sequenceStartMS = 0;
+		sequenceShownFrame = 0xFFFFFFFF;
+		sequenceLateFrames = 0;
+		frameTimeUS = 0;
+		frameDueUS = 0;
+		idle = false;
+		idleWakeMS = 0;
 		cyclePatternTimeMS = 0;
 		cyclePatternCount = 0;
 		testPatternValue = 0;
 
-		ledsOn = false;
-		motionSensorTriggered = false;
-		timeOfDay = 0;
+		ledsOn = false;
+		motionSensorTriggered = false;
+		motionCallbackUS = 0;
+		motionResponsePending = false;
+		memset(&motionStats, 0, sizeof(motionStats));
+		timeOfDay = 0;
+		telemetryHead = 0;
+		telemetryTail = 0;
+		telemetryLost = 0;
+		telemetryBatches = 0;
+		telemetryFlushMS = 0;
+		telemetryFramesMS = 0;
+		telemetryFramesShown = 0;
+		telemetryFramesDropped = 0;
+		telemetryMaxUpdateUS = 0;
+		telemetryPattern = NULL;
+		telemetryViewMode = 0xFF;
+
+		luminosityInterface = new CTSL2561Sensor(0x39, eGain_1X, eIntegrationTime_13_7ms);
+		if(!luminosityInterface->IsPresent())
+		{
+			luminosityInterface = NULL;
+		}
+
+		// Include dependent modules
+
+		CModule_Loggly*			loggly = CModule_Loggly::Include("front_house");
+		IRealTimeDataProvider*	ds3234Provider = CreateDS3234Provider(eRTCChipSelect);
+		IRealTimeDataProvider*	networkProvider = CreateNTPProvider("2.us.pool.ntp.org", 123);
+		IInternetDevice*		internetDevice = CModule_ESP8266::Include(&Serial1, eESP8266ResetPin);
+
+		CModule_RealTime::Include();
+		CModule_Internet::Include();
+		CModule_Command::Include();
+		CModule_OutdoorLightingControl::Include(this, false, eMotionSensorPin, eTransformerRelayPin, eToggleButtonPin, luminosityInterface);
+
+		AddSysMsgHandler(loggly);
+		gRealTime->Configure(ds3234Provider, networkProvider, 1 * 60 * 60);
+		gInternetModule->Configure(internetDevice);
+		ledsOn = false;
+	}
+
+	void
+	Setup(
+		void)
+	{
+#if defined(ARM_DWT_CYCCNT)
+		// Enable the cycle counter used for profiling
+		ARM_DEMCR |= ARM_DEMCR_TRCENA;
+		ARM_DWT_CTRL |= ARM_DWT_CTRL_CYCCNTENA;
+#endif
+
+		// The led output starts first so the roof shows the last known state while the sd card, network and clock come up
+		LoadUserPatterns();
+		BuildGammaCurve();
+		leds.begin();
+		ShowBootState();
+
+		sdPresent = SD.begin(eSDChipSelect);
+		SystemMsg(sdPresent ? "SD card present" : "SD card missing");
+
+		if(luminosityInterface != NULL)
+		{
+			SystemMsg("Luminosity sensor present");
+			luminosityInterface->SetMinMaxLux(settings.minLux, settings.maxLux);
+		}
+		else
+		{
+			SystemMsg("Luminosity sensor missing");
+		}
+
+		// Configure the time provider on the standard SPI chip select pin
+
+		// Instantiate the wireless networking device and configure it to serve pages
+		gInternetModule->WebServer_Start(8080);
+		MInternetRegisterPage("/", COutdoorLightingModule::CommandHomePageHandler);
+		MInternetRegisterPage("/status.json", COutdoorLightingModule::StatusJSONHandler);
+
+		// Register the commands
+		MCommandRegister("test_pattern", COutdoorLightingModule::TestPattern, "");
+		MCommandRegister("settings_set", COutdoorLightingModule::SetSettings, "[key=value ...] : set several settings at once, keys are color=r,g,b default active minlux maxlux fade gamma balance=r,g,b period dither power channelma luxcurve=a,b,c,d,e luxdeadband luxhysteresis luxsteps waveentry wavetime");
+		MCommandRegister("color_set", COutdoorLightingModule::SetColor, "");
+		MCommandRegister("color_get", COutdoorLightingModule::GetColor, "");
+		MCommandRegister("intensity_set", COutdoorLightingModule::SetIntensity, "[default] [active] : set the intensity levels");
+		MCommandRegister("intensity_get", COutdoorLightingModule::GetIntensity, "");
+		MCommandRegister("luxminmax_set", COutdoorLightingModule::SetMinMaxLux, "");
+		MCommandRegister("luxminmax_get", COutdoorLightingModule::GetMinMaxLux, "");
+		MCommandRegister("luxcurve_get", COutdoorLightingModule::GetLuxCurve, ": the lux intensity curve, deadband, hysteresis and steps and the brightness the intensity was last found from");
+		MCommandRegister("fade_set", COutdoorLightingModule::SetFadeTime, "[ms] : set the time to fade between the lowest and highest intensity");
+		MCommandRegister("fade_get", COutdoorLightingModule::GetFadeTime, "");
+		MCommandRegister("gamma_set", COutdoorLightingModule::SetGamma, "[gamma] [r g b] : set the output gamma and optionally the per channel color balance");
+		MCommandRegister("gamma_get", COutdoorLightingModule::GetGamma, "");
+		MCommandRegister("dither_set", COutdoorLightingModule::SetDither, "[on|off] [frame period us] : set temporal dithering and optionally the frame period");
+		MCommandRegister("dither_get", COutdoorLightingModule::GetDither, "");
+		MCommandRegister("power_set", COutdoorLightingModule::SetPower, "[budget ma] [channel ma] : set the current budget of the leds, 0 for no limit, and optionally the current of one fully on channel");
+		MCommandRegister("power_get", COutdoorLightingModule::GetPower, ": the budget, estimated current and limit scale");
+		MCommandRegister("framestats_get", COutdoorLightingModule::GetFrameStats, ": frames shown, frames dropped because DMA was busy, worst update time and updates skipped while the output was static and the shown frame rates");
+		MCommandRegister("framestats_reset", COutdoorLightingModule::ResetFrameStats, "");
+		MCommandRegister("motionstats_get", COutdoorLightingModule::GetMotionStats, ": the time from the motion callback to its response being on the leds, the sensor polling before the callback is not included");
+		MCommandRegister("motionstats_reset", COutdoorLightingModule::ResetMotionStats, "");
+		MCommandRegister("telemetry_get", COutdoorLightingModule::GetTelemetry, ": the telemetry records recorded, waiting to be sent, lost to a full ring and the batches sent");
+		MCommandRegister("telemetry_flush", COutdoorLightingModule::FlushTelemetry, ": send the waiting telemetry records now");
+		MCommandRegister("perf_get", COutdoorLightingModule::GetPerf, ": min/avg/max us of each frame stage over the last 32 frames");
+		MCommandRegister("perf_reset", COutdoorLightingModule::ResetPerf, "");
+		MCommandRegister("stream", COutdoorLightingModule::StreamPacket, "[sequence] [sender ms] [first led] [flags] [rgb hex] : show streamed pixels, 1 in flags ends the frame");
+		MCommandRegister("stream_codec", COutdoorLightingModule::StreamCodecPacket, "[sequence] [sender ms] [packet hex] : show a streamed FHFrameCodec packet");
+		MCommandRegister("streamstats_get", COutdoorLightingModule::GetStreamStats, ": packets, loss, latency and frame rate of the pixel stream");
+		MCommandRegister("streamstats_reset", COutdoorLightingModule::ResetStreamStats, "");
+		MCommandRegister("sequence_play", COutdoorLightingModule::PlaySequence, "[file] [hh:mm:ss] : play a sequence from the sd card, looping from the given time of day or from now");
+		MCommandRegister("sequence_stop", COutdoorLightingModule::StopSequence, "");
+		MCommandRegister("sequence_get", COutdoorLightingModule::GetSequence, ": the playing sequence and its late frames, seeks and read errors");
+		MCommandRegister("sync_get", COutdoorLightingModule::GetSync, ": print the sync_set command that makes a follower draw the same frames as this controller");
+		MCommandRegister("sync_set", COutdoorLightingModule::SetSync, "[pattern index] [pattern ms] [intensity] : follow the state of a sync master");
+		MCommandRegister("sync_stop", COutdoorLightingModule::StopSyncCmd, "");
+		MCommandRegister("pattern_add", COutdoorLightingModule::AddUserPattern, "[hex] : store a user pattern descriptor in a free slot");
+		MCommandRegister("pattern_remove", COutdoorLightingModule::RemoveUserPattern, "[slot]");
+		MCommandRegister("pattern_list", COutdoorLightingModule::ListUserPatterns, "");
+		MCommandRegister("layer_add", COutdoorLightingModule::AddLayerCmd, "[sweep|sparkle|flash] [over|add|max|multiply] [rrggbb] [first led] [led count] [period ms] [duration ms, 0 to keep] [param] : composite an effect over the pattern");
+		MCommandRegister("layer_remove", COutdoorLightingModule::RemoveLayerCmd, "[slot]");
+		MCommandRegister("layer_list", COutdoorLightingModule::ListLayers, "");
+		MCommandRegister("bench", COutdoorLightingModule::Benchmark, "[frames] : time the render paths of every pattern without sending frames to the leds");
+
+		// A saved pattern cycle or test pattern forces the leds on the same way the push button does
+		if(viewMode != eViewMode_Normal)
+		{
+			gOutdoorLighting->SetOverride(true, true);
+		}
+		else if(bootStateShown)
+		{
+			// The transformer relay is only switched by the lighting control so it is held on until the boot state ends
+			bootOverride = true;
+			gOutdoorLighting->SetOverride(true, true);
+		}
+
+		SystemMsg("First frame %lu us after power on", (unsigned long)bootFrameUS);
+	}
+
+	// Show the state saved in the settings, it is kept until the lighting control gives the led state the usual way
+	void
+	ShowBootState(
+		void)
+	{
+		SBootState const&	boot = settings.boot;
+
+		viewMode = boot.viewMode <= eViewMode_TestPattern ? boot.viewMode : uint8_t(eViewMode_Normal);
+		basePattern = GetEnabledPattern(boot.patternIndex);
+		if(boot.intensity > 0.0f)
+		{
+			bootStateShown = true;
+			ledsOn = true;
+			currentIntensity = GetTargetIntensity();
+			RenderFrame(0);
+		}
+
+		// The leds are cleared of whatever they powered up with even if the saved state is off
+		ShowFrame(true);
+	}
+
+	// Save the state the leds are shown with in the settings if it has changed, this is not done while the boot state is shown so it is not lost
+	// The intensity saved leaves out motion so a boot does not start at the active intensity, and lux so the settings are not written every lux step
+	void
+	SnapshotBootState(
+		void)
+	{
+		if(bootStateShown)
+		{
+			return;
+		}
+
+		int		patternIndex = GetBasePatternIndex();
+		uint8_t	mode = viewMode <= eViewMode_TestPattern ? viewMode : uint8_t(eViewMode_Normal);
+		float	intensity = 0.0f;
+
+		if(ledsOn)
+		{
+			intensity = settings.defaultIntensity;
+		}
+
+		if(settings.boot.patternIndex == uint8_t(patternIndex) && settings.boot.viewMode == mode && settings.boot.intensity == intensity)
+		{
+			return;
+		}
+
+		settings.boot.patternIndex = uint8_t(patternIndex);
+		settings.boot.viewMode = mode;
+		settings.boot.intensity = intensity;
+		SettingsChanged();
+	}
+
+	// The lighting control may only report the led state when it changes, so if it has not once the clock is valid the leds are off
+	void
+	UpdateBootState(
+		void)
+	{
+		if(bootTimeValidMS == 0)
+		{
+			if(gRealTime->GetEpochTime(false) >= uint32_t(eMinValidEpoch))
+			{
+				bootTimeValidMS = gCurLocalMS > 0 ? gCurLocalMS : 1;
+			}
+			return;
+		}
+
+		if(gCurLocalMS - bootTimeValidMS >= eBootStateMaxMS)
+		{
+			SystemMsg("Boot state expired");
+			LEDStateChange(false);
+		}
+	}
+
+	void
+	CommandHomePageHandler(
+		IOutputDirector*	inOutput,
+		int					inParamCount,
+		char const**		inParamList)
+	{
+		// Send html via in Output to add to the command server home page served to clients
+		UpdateStatusPage();
+
+		// The frame times change every frame so they are appended to the cached html
+		uint32_t	perfAvg[ePerfStageCount];
+		for(int itr = 0; itr < ePerfStageCount; ++itr)
+		{
+			uint32_t	minUS, maxUS;
+			perfRing[itr].GetStatsUS(minUS, perfAvg[itr], maxUS);
+		}
+
+		char	buffer[eStatusTailSize];
+		int		len = snprintf(buffer, sizeof(buffer), "<tr><td>Frame us</td><td>draw:%lu scale:%lu blit:%lu show:%lu outside:%lu</td></tr></table>",
+			(unsigned long)perfAvg[ePerfStage_Draw], (unsigned long)perfAvg[ePerfStage_Scale], (unsigned long)perfAvg[ePerfStage_Blit], (unsigned long)perfAvg[ePerfStage_Show], (unsigned long)perfAvg[ePerfStage_Outside]);
+		inOutput->write(statusPageHTML, statusPageHTMLLen);
+		inOutput->write(buffer, len < int(sizeof(buffer)) ? len : sizeof(buffer) - 1);
+	}
+
+	void
+	StatusJSONHandler(
+		IOutputDirector*	inOutput,
+		int					inParamCount,
+		char const**		inParamList)
+	{
+		// Send a compact json version of the home page for polling clients
+		UpdateStatusPage();
+
+		char	buffer[eStatusTailSize];
+		int		len = snprintf(buffer, sizeof(buffer), ",\"ledsOn\":%d,\"intensity\":%.3f,\"framesShown\":%lu,\"framesDropped\":%lu,\"sync\":[%d,%lu,%.3f]}",
+			ledsOn, currentIntensity, (unsigned long)frameStats.framesShown, (unsigned long)frameStats.framesDropped,
+			GetBasePatternIndex(), (unsigned long)GetPatternTimeMS(), syncActive ? syncIntensity : GetTargetIntensity());
+		inOutput->write(statusPageJSON, statusPageJSONLen);
+		inOutput->write(buffer, len < int(sizeof(buffer)) ? len : sizeof(buffer) - 1);
+	}
+
+	// Rebuild the cached home page html and json status if the settings, view mode or pattern have changed since they were last built, SettingsChanged() clears statusPageValid
+	void
+	UpdateStatusPage(
+		void)
+	{
+		if(statusPageValid && statusViewMode == viewMode && statusPattern == basePattern)
+		{
+			return;
+		}
+
+		statusPageValid = true;
+		statusViewMode = viewMode;
+		statusPattern = basePattern;
+
+		char const*	patternName = basePattern != NULL ? basePattern->GetName() : "None";
+
+		statusPageHTMLLen = snprintf(statusPageHTML, sizeof(statusPageHTML),
+			"<table border=\"1\">"
+			"<tr><th>Parameter</th><th>Value</th></tr>"
+			"<tr><td>Holiday</td><td>%s</td></tr>"
+			"<tr><td>View Mode</td><td>%s</td></tr>"
+			"<tr><td>Default Color</td><td>r:%01.02f g:%01.02f b:%01.02f</td></tr>"
+			"<tr><td>Default Intensity</td><td>%01.02f</td></tr>"
+			"<tr><td>Active Intensity</td><td>%01.02f</td></tr>"
+			"<tr><td>Fade Time</td><td>%lu ms</td></tr>"
+			"<tr><td>Gamma</td><td>%01.02f r:%01.02f g:%01.02f b:%01.02f</td></tr>"
+			"<tr><td>Lux Range</td><td>%f %f</td></tr>"
+			"<tr><td>Power Budget</td><td>%lu ma</td></tr>",
+			patternName,
+			gViewModeStr[viewMode],
+			settings.defaultColor.r, settings.defaultColor.g, settings.defaultColor.b,
+			settings.defaultIntensity,
+			settings.activeIntensity,
+			(unsigned long)settings.fadeTimeMS,
+			settings.gamma, settings.colorBalance.r, settings.colorBalance.g, settings.colorBalance.b,
+			settings.minLux, settings.maxLux,
+			(unsigned long)settings.powerBudgetMA);
+
+		// The json is left open so the handler can append the values that change every frame
+		statusPageJSONLen = snprintf(statusPageJSON, sizeof(statusPageJSON),
+			"{\"holiday\":\"%s\",\"viewMode\":\"%s\",\"defaultColor\":[%.3f,%.3f,%.3f],\"defaultIntensity\":%.3f,\"activeIntensity\":%.3f,"
+			"\"fadeTimeMS\":%lu,\"gamma\":%.3f,\"colorBalance\":[%.3f,%.3f,%.3f],\"minLux\":%.1f,\"maxLux\":%.1f,\"framePeriodUS\":%lu,\"dither\":%d,\"powerBudgetMA\":%lu",
+			patternName,
+			gViewModeStr[viewMode],
+			settings.defaultColor.r, settings.defaultColor.g, settings.defaultColor.b,
+			settings.defaultIntensity,
+			settings.activeIntensity,
+			(unsigned long)settings.fadeTimeMS,
+			settings.gamma, settings.colorBalance.r, settings.colorBalance.g, settings.colorBalance.b,
+			settings.minLux, settings.maxLux,
+			(unsigned long)settings.framePeriodUS,
+			settings.dither,
+			(unsigned long)settings.powerBudgetMA);
+
+		// A truncated page is sent as far as it fits
+		if(statusPageHTMLLen >= int(sizeof(statusPageHTML)))
+		{
+			statusPageHTMLLen = sizeof(statusPageHTML) - 1;
+		}
+		if(statusPageJSONLen >= int(sizeof(statusPageJSON)))
+		{
+			statusPageJSONLen = sizeof(statusPageJSON) - 1;
+		}
+	}
+
+	virtual void
+	LEDStateChange(
+		bool	inLEDsOn)
+	{
+		ledsOn = inLEDsOn;
+		bootStateShown = false;
+		Wake();
+
+		if(bootOverride)
+		{
+			// From now on the lighting control decides whether the leds are on
+			bootOverride = false;
+			gOutdoorLighting->SetOverride(false, false);
+		}
+
+		if(ledsOn == false)
+		{
+			// turn all LEDs off
+			for(uint32_t itr = 0; itr < eLEDCount; ++itr)
+			{
+				SetRoofPixel(itr, 0, 0, 0);
+			}
+			ShowFrame(true);
+		}
+		else
+		{
+			// A sync follower keeps the master's pattern
+			if(syncActive == false)
+			{
+				FindBasePattern();
+			}
+			InvalidateFrame();
+		}
+
+		SnapshotBootState();
+	}
+
+	virtual void
+	MotionSensorStateChange(
+		bool	inMotionSensorTriggered)
+	{
+		bool	rising = inMotionSensorTriggered && motionSensorTriggered == false;
+
+		if(inMotionSensorTriggered != motionSensorTriggered)
+		{
+			AddTelemetry(eTelemetry_Motion, inMotionSensorTriggered, 0, 0);
+		}
+
+		motionSensorTriggered = inMotionSensorTriggered;
+		Wake();
+
+		if(rising == false || ledsOn == false || viewMode != eViewMode_Normal || syncActive)
+		{
+			return;
+		}
+
+		motionCallbackUS = micros();
+		motionResponsePending = true;
+		++motionStats.edges;
+
+		StartMotionWave();
+
+		// Render the response now rather than waiting for the next update tick, if DMA is busy the frame goes out on the next tick
+		RenderFrame(frameTimeUS);
+		frameTimeUS = 0;
+		frameDueUS = 0;
+		ShowFrame(false);
+	}
+
+	// The intensity jumps to the active level and a wave layer holds back the leds it has not reached yet so the leds near the entry brighten first
+	void
+	StartMotionWave(
+		void)
+	{
+		float	target = GetTargetIntensity();
+
+		if(settings.waveTimeMS == 0 || settings.waveEntryLED >= eLEDCount || target <= currentIntensity)
+		{
+			return;
+		}
+
+		// Multiplying the frame buffer by the ratio of the intensities shows the leds outside the wave at the current intensity
+		SPixel	hold;
+		uint8_t	level = uint8_t(currentIntensity / target * 255.0f + 0.5f);
+
+		SetPixelRGB(hold, level, level, level);
+		if(AddLayer(&gWaveEffect, eBlend_Multiply, hold, 0, eLEDCount, settings.waveTimeMS, settings.waveTimeMS, settings.waveEntryLED) >= 0)
+		{
+			currentIntensity = target;
+		}
+	}
+
+	virtual void
+	LuxSensorStateChange(
+		bool	inTriggered)
+	{
+		Wake();
+	}
+
+	virtual void
+	PushButtonStateChange(
+		int	inToggleCount)
+	{
+		if(inToggleCount == ePushCount_CyclePatterns)
+		{
+			SystemMsg("Entering pattern cycling\n");
+			viewMode = eViewMode_CyclePatterns;
+			InvalidateFrame();
+			gOutdoorLighting->SetOverride(true, true);
+		}
+		else if(inToggleCount == ePushCount_TestPattern)
+		{
+			SystemMsg("Entering test pattern\n");
+			viewMode = eViewMode_TestPattern;
+			InvalidateFrame();
+			gOutdoorLighting->SetOverride(true, true);
+		}
+		else
+		{
+			SystemMsg("Entering normal mode\n");
+			viewMode = eViewMode_Normal;
+			InvalidateFrame();
+			gOutdoorLighting->SetOverride(false, false);
+		}
+	}
+
+	virtual void
+	TimeOfDayChange(
+		int	inTimeOfDay)
+	{
+		timeOfDay = inTimeOfDay;
+		Wake();
+	}
+
+	void
+	Update(
+		uint32_t inTickTimeUS)
+	{
+		uint32_t	entryCycles = GetCycleCount();
+
+		if(updateExitCycles != 0 && entryCycles - updateExitCycles > perfFrame[ePerfStage_Outside])
+		{
+			perfFrame[ePerfStage_Outside] = entryCycles - updateExitCycles;
+		}
+
+		// Settings changes are coalesced into one eeprom write once they stop changing
+		if(settingsDirty && gCurLocalMS - settingsChangedMS >= eSettingsSaveDelayMS)
+		{
+			settingsDirty = false;
+			EEPROMSave();
+		}
+
+		// Telemetry is sent even while idle so records are not held back by a static frame
+		SendTelemetry();
+
+		// The shown frame rate is measured including idle time so a static frame reads as the rate it is really sent at
+		uint32_t	windowMS = uint32_t(gCurLocalMS - frameStats.windowStartMS);
+		if(windowMS >= eFrameRateWindowMS)
+		{
+			frameStats.windowFPS = uint32_t(uint64_t(frameStats.framesShown - frameStats.windowFrames) * 1000 / windowMS);
+			if(frameStats.windowFPS > frameStats.peakFPS)
+			{
+				frameStats.peakFPS = frameStats.windowFPS;
+			}
+			frameStats.windowFrames = frameStats.framesShown;
+			frameStats.windowStartMS = gCurLocalMS;
+		}
+
+		if(bootStateShown)
+		{
+			UpdateBootState();
+		}
+
+		// A static frame is not rerendered until it is woken by an event or its deadline passes
+		if(idle)
+		{
+			if(int64_t(gCurLocalMS - idleWakeMS) < 0)
+			{
+				++frameStats.idleTicks;
+				updateExitCycles = GetCycleCount();
+				return;
+			}
+			Wake();
+		}
+
+		UpdateTick(inTickTimeUS);
+
+		updateExitCycles = GetCycleCount();
+	}
+
+	void
+	UpdateTick(
+		uint32_t inTickTimeUS)
+	{
+		if(ledsOn == false)
+		{
+			// Finish sending the off frame if DMA was busy when the leds were turned off
+			ShowFrame(false);
+			if(showPending == false)
+			{
+				// Nothing changes until the leds are turned on
+				Sleep(eIdleMaxMS);
+			}
+			return;
+		}
+
+		if(viewMode == eViewMode_Stream && gCurLocalMS - streamLastPacketMS >= eStreamTimeoutMS)
+		{
+			SystemMsg("Stream timed out");
+			StopStream();
+		}
+
+		// Prefetch sequence frames every tick so reads are spread out between frames
+		if(viewMode == eViewMode_Sequence)
+		{
+			sequencePlayer.Fill();
+		}
+
+		if(syncActive && gCurLocalMS - syncLastMS >= eSyncTimeoutMS)
+		{
+			StopSync();
+		}
+
+		if(syncActive)
+		{
+			SlewSyncOffset();
+		}
+
+		// Switch to the next holiday pattern at midnight without waiting for the leds to turn on again
+		if(viewMode == eViewMode_Normal && syncActive == false && gCurLocalMS - calendarCheckMS >= eCalendarCheckMS)
+		{
+			calendarCheckMS = gCurLocalMS;
+			if(gRealTime->GetEpochTime(false) >= nextPatternChangeEpoch)
+			{
+				FindBasePattern();
+			}
+		}
+
+		// The module is polled faster than the frame rate so the frame period can be configured at run time
+		frameTimeUS += inTickTimeUS;
+		frameDueUS += inTickTimeUS;
+		if(frameDueUS < GetFramePeriodUS())
+		{
+			// Keep retrying a frame that was deferred because DMA was busy
+			ShowFrame(false);
+			return;
+		}
+
+		// The time past the deadline carries to the next frame so the average rate is the frame period even when it is not a multiple of the tick, after a stall the frames do not catch up
+		frameDueUS -= GetFramePeriodUS();
+		if(frameDueUS >= GetFramePeriodUS())
+		{
+			frameDueUS = 0;
+		}
+
+		uint32_t	startUS = micros();
+		uint16_t	prevPowerLimitScale = powerLimitScale;
+
+		RenderFrame(frameTimeUS);
+		frameTimeUS = 0;
+
+		ShowFrame(false);
+
+		if(basePattern != telemetryPattern || viewMode != telemetryViewMode)
+		{
+			telemetryPattern = basePattern;
+			telemetryViewMode = viewMode;
+			AddTelemetry(eTelemetry_Pattern, viewMode, uint16_t(GetBasePatternIndex()), 0);
+		}
+
+		SnapshotBootState();
+
+		if(IsOutputStatic(prevPowerLimitScale))
+		{
+			Sleep(GetIdleTimeMS());
+		}
+
+		uint32_t	updateUS = micros() - startUS;
+		if(updateUS > frameStats.maxUpdateUS)
+		{
+			frameStats.maxUpdateUS = updateUS;
+		}
+		if(updateUS > telemetryMaxUpdateUS)
+		{
+			telemetryMaxUpdateUS = updateUS;
+		}
+
+		if(gCurLocalMS - telemetryFramesMS >= eTelemetryFramesMS)
+		{
+			uint32_t	dropped = frameStats.framesDropped - telemetryFramesDropped;
+			uint32_t	shown = frameStats.framesShown - telemetryFramesShown;
+
+			AddTelemetry(eTelemetry_Frames, uint8_t(dropped < 0xFF ? dropped : 0xFF), uint16_t(shown < 0xFFFF ? shown : 0xFFFF), telemetryMaxUpdateUS);
+			telemetryFramesMS = gCurLocalMS;
+			telemetryFramesDropped = frameStats.framesDropped;
+			telemetryFramesShown = frameStats.framesShown;
+			telemetryMaxUpdateUS = 0;
+		}
+
+		for(int itr = 0; itr < ePerfStageCount; ++itr)
+		{
+			perfRing[itr].Add(perfFrame[itr]);
+			perfFrame[itr] = 0;
+		}
+	}
+
+	void
+	AddPerfTime(
+		int			inStage,
+		uint32_t	inStartCycles)
+	{
+		perfFrame[inStage] += GetCycleCount() - inStartCycles;
+	}
+
+	// Write a telemetry record to the ring, this never formats or blocks so it can be used on the hot path
+	// If the ring is full because the log has not kept up the oldest record is lost
+	void
+	AddTelemetry(
+		uint8_t		inKind,
+		uint8_t		inA,
+		uint16_t	inB,
+		uint32_t	inC)
+	{
+		if(telemetryHead - telemetryTail >= eTelemetryRingSize)
+		{
+			++telemetryTail;
+			++telemetryLost;
+		}
+
+		STelemetryRecord&	record = telemetryRing[telemetryHead++ & (eTelemetryRingSize - 1)];
+
+		record.timeMS = uint32_t(gCurLocalMS);
+		record.kind = inKind;
+		record.a = inA;
+		record.b = inB;
+		record.c = inC;
+	}
+
+	// Once the flush interval has passed send the waiting records one batch per update so a flush never holds up the frames,
+	// the log only queues the message so a network outage costs records lost from the ring rather than time
+	void
+	SendTelemetry(
+		void)
+	{
+		if(telemetryHead == telemetryTail || gCurLocalMS - telemetryFlushMS < eTelemetryFlushMS)
+		{
+			return;
+		}
+
+		// The records are packed as the kind then varints of the ms since the previous record and the a, b and c fields, then sent as hex
+		static char const	cHexDigits[] = "0123456789abcdef";
+		uint8_t				packed[eTelemetryBatchRecords * 16];
+		char				hex[sizeof(packed) * 2 + 1];
+		int					packedSize = 0;
+		uint32_t			baseMS = telemetryRing[telemetryTail & (eTelemetryRingSize - 1)].timeMS;
+		uint32_t			prevMS = baseMS;
+		uint32_t			lost = telemetryLost;
+
+		for(int itr = 0; itr < eTelemetryBatchRecords && telemetryTail != telemetryHead; ++itr, ++telemetryTail)
+		{
+			STelemetryRecord const&	record = telemetryRing[telemetryTail & (eTelemetryRingSize - 1)];
+			uint32_t				fields[4] = {record.timeMS - prevMS, record.a, record.b, record.c};
+
+			packed[packedSize++] = record.kind;
+			for(int fieldItr = 0; fieldItr < 4; ++fieldItr)
+			{
+				uint32_t	value = fields[fieldItr];
+
+				while(value >= 0x80)
+				{
+					packed[packedSize++] = uint8_t(value | 0x80);
+					value >>= 7;
+				}
+				packed[packedSize++] = uint8_t(value);
+			}
+
+			prevMS = record.timeMS;
+		}
+
+		for(int itr = 0; itr < packedSize; ++itr)
+		{
+			hex[itr * 2] = cHexDigits[packed[itr] >> 4];
+			hex[itr * 2 + 1] = cHexDigits[packed[itr] & 0xF];
+		}
+		hex[packedSize * 2] = 0;
+
+		telemetryLost = 0;
+		++telemetryBatches;
+		SystemMsg("telemetry %lu %lu %lu %s", (unsigned long)telemetryBatches, (unsigned long)lost, (unsigned long)baseMS, hex);
+
+		// The interval starts again once every waiting record has been sent
+		if(telemetryHead == telemetryTail)
+		{
+			telemetryFlushMS = gCurLocalMS;
+		}
+	}
+
+	// Receive a packet of 8 bit rgb pixels from a stream, this does not depend on the transport the packets arrive over
+	// The pixels are written straight to outputFrame and are sent to the leds once the packet that ends the frame arrives
+	void
+	StreamPacketReceived(
+		uint8_t			inSequence,
+		uint32_t		inSenderMS,
+		int				inFirstLED,
+		int				inLEDCount,
+		uint8_t const*	inRGB,
+		uint8_t			inFlags)
+	{
+		StreamPacketStarted(inSequence, inSenderMS, inLEDCount * 3);
+
+		if(inFirstLED < 0 || inFirstLED + inLEDCount > eLEDCount)
+		{
+			return;
+		}
+
+		for(int itr = 0; itr < inLEDCount; ++itr, inRGB += 3)
+		{
+			SRGBPixel&	curPixel = outputFrame[inFirstLED + itr];
+
+			if(curPixel.r != inRGB[0] || curPixel.g != inRGB[1] || curPixel.b != inRGB[2])
+			{
+				curPixel.r = inRGB[0];
+				curPixel.g = inRGB[1];
+				curPixel.b = inRGB[2];
+				streamDirty.Add(inFirstLED + itr);
+			}
+		}
+
+		if(inFlags & eStreamFlag_FrameEnd)
+		{
+			StreamFrameEnded();
+		}
+	}
+
+	// Receive a packet in the FHFrameCodec format, delta packets are dropped until a keyframe arrives after any packet is lost
+	void
+	StreamCodecPacketReceived(
+		uint8_t			inSequence,
+		uint32_t		inSenderMS,
+		uint8_t const*	inPacket,
+		int				inPacketSize)
+	{
+		uint32_t	lostCount = streamStats.packetsLost;
+
+		StreamPacketStarted(inSequence, inSenderMS, inPacketSize);
+
+		if(streamStats.packetsLost != lostCount)
+		{
+			streamFrameLoss = true;
+			streamBaseValid = false;
+		}
+
+		uint8_t	flags = inPacketSize > 0 ? inPacket[0] : 0;
+		bool	keyFrame = (flags & eFrameCodecFlag_KeyFrame) != 0;
+		bool	decoded = false;
+
+		if(keyFrame || streamBaseValid)
+		{
+			// Decode straight into outputFrame, it holds the previous frame the deltas apply to
+			int	dirtyStart, dirtyEnd;
+
+			decoded = FrameCodecDecode(inPacket, inPacketSize, (uint8_t*)outputFrame, eLEDCount, dirtyStart, dirtyEnd);
+			if(dirtyStart < dirtyEnd)
+			{
+				streamDirty.Add(dirtyStart, dirtyEnd);
+			}
+		}
+
+		if(decoded == false)
+		{
+			// A bad packet leaves its leds as they were, the frame then differs from the sender's so the deltas that follow need a keyframe first
+			++streamStats.packetsDropped;
+			streamFrameLoss = true;
+			streamBaseValid = false;
+		}
+
+		if(flags & eFrameCodecFlag_FrameEnd)
+		{
+			if(keyFrame && streamFrameLoss == false)
+			{
+				streamBaseValid = true;
+			}
+			streamFrameLoss = false;
+			StreamFrameEnded();
+		}
+	}
+
+	// Update the stream stats for a packet, this enters stream mode if it is the first one
+	void
+	StreamPacketStarted(
+		uint8_t		inSequence,
+		uint32_t	inSenderMS,
+		int			inBytes)
+	{
+		if(viewMode != eViewMode_Stream)
+		{
+			SystemMsg("Entering stream mode");
+			viewMode = eViewMode_Stream;
+			streamDirty.Clear();
+			memset(&streamStats, 0, sizeof(streamStats));
+			streamStats.startMS = gCurLocalMS;
+			streamStats.nextSequence = inSequence;
+			streamStats.minClockOffsetMS = int32_t(uint32_t(gCurLocalMS) - inSenderMS);
+			streamBaseValid = false;
+			streamFrameLoss = false;
+			gOutdoorLighting->SetOverride(true, true);
+			Wake();
+		}
+
+		streamLastPacketMS = gCurLocalMS;
+		++streamStats.packetsReceived;
+		streamStats.packetsLost += uint8_t(inSequence - streamStats.nextSequence);
+		streamStats.nextSequence = uint8_t(inSequence + 1);
+		streamStats.bytesReceived += inBytes;
+
+		// The sender clock is not synchronized so latency is measured over the fastest packet seen
+		int32_t	clockOffsetMS = int32_t(uint32_t(gCurLocalMS) - inSenderMS);
+		if(clockOffsetMS < streamStats.minClockOffsetMS)
+		{
+			streamStats.minClockOffsetMS = clockOffsetMS;
+		}
+
+		uint32_t	latencyMS = uint32_t(clockOffsetMS - streamStats.minClockOffsetMS);
+		streamStats.totalLatencyMS += latencyMS;
+		if(latencyMS > streamStats.maxLatencyMS)
+		{
+			streamStats.maxLatencyMS = latencyMS;
+		}
+	}
+
+	// Send the leds written since the last frame to the display
+	void
+	StreamFrameEnded(
+		void)
+	{
+		++streamStats.framesReceived;
+		if(ledsOn && streamDirty.IsEmpty() == false)
+		{
+			outputDirty.Add(streamDirty.start, streamDirty.end);
+			streamDirty.Clear();
+		}
+
+		// The stream writes outputFrame directly so the current estimate is recounted, the codec deltas apply to the values as sent so the limit is applied as the frame is blit
+		outputSum = 0;
+		for(int itr = 0; itr < eLEDCount; ++itr)
+		{
+			outputSum += outputFrame[itr].r + outputFrame[itr].g + outputFrame[itr].b;
+		}
+		UpdateRawPowerLimit();
+	}
+
+	// Return to the holiday pattern
+	void
+	StopStream(
+		void)
+	{
+		viewMode = eViewMode_Normal;
+		InvalidateFrame();
+		gOutdoorLighting->SetOverride(false, false);
+	}
+
+	// Return true if rendering another frame would not change the output until an event arrives
+	bool
+	IsOutputStatic(
+		uint16_t	inPrevPowerLimitScale)
+	{
+		return viewMode == eViewMode_Normal && syncActive == false && frameBufferValid && showPending == false && settingsDirty == false && activeLayerCount == 0
+			&& settings.dither == 0 && powerLimitScale == inPrevPowerLimitScale
+			&& (basePattern == NULL || basePattern->IsAnimated() == false)
+			&& currentIntensity == GetTargetIntensity();
+	}
+
+	// Get how long a static frame can go without being rendered, this is the time to the next holiday pattern or the next lux check
+	uint32_t
+	GetIdleTimeMS(
+		void)
+	{
+		uint32_t	idleMS = eIdleMaxMS;
+
+		if(nextPatternChangeEpoch != 0xFFFFFFFF)
+		{
+			uint32_t	epoch = gRealTime->GetEpochTime(false);
+			uint32_t	secondsLeft = nextPatternChangeEpoch > epoch ? nextPatternChangeEpoch - epoch : 0;
+
+			if(secondsLeft < idleMS / 1000)
+			{
+				idleMS = secondsLeft * 1000 > eCalendarCheckMS ? secondsLeft * 1000 : uint32_t(eCalendarCheckMS);
+			}
+		}
+
+		// The target intensity follows the lux sensor at night unless motion has set it
+		if(luminosityInterface != NULL && timeOfDay != eTimeOfDay_Day && motionSensorTriggered == false && idleMS > eIdleLuxPollMS)
+		{
+			idleMS = eIdleLuxPollMS;
+		}
+
+		return idleMS;
+	}
+
+	// Stop rendering frames for inMS or until Wake() is called
+	void
+	Sleep(
+		uint32_t	inMS)
+	{
+		idle = true;
+		idleWakeMS = gCurLocalMS + inMS;
+	}
+
+	// Resume rendering, call this from anything that can change the output of a static frame
+	void
+	Wake(
+		void)
+	{
+		if(idle)
+		{
+			idle = false;
+
+			// Render on the next tick, the fade steps by one frame period rather than the whole time spent idle
+			frameTimeUS = GetFramePeriodUS();
+			frameDueUS = GetFramePeriodUS();
+		}
+	}
+
+	// Get the intensity normal mode fades towards from the time of day, motion and lux
+	float
+	GetTargetIntensity(
+		void)
+	{
+		if(bootStateShown)
+		{
+			// The saved intensity leaves out lux so it is applied again here
+			return luminosityInterface != NULL ? GetLuxIntensity() * settings.boot.intensity : settings.boot.intensity;
+		}
+
+		if(timeOfDay == eTimeOfDay_Day)
+		{
+			return 1.0;
+		}
+
+		if(motionSensorTriggered)
+		{
+			return settings.activeIntensity;
+		}
+
+		if(luminosityInterface != NULL)
+		{
+			return GetLuxIntensity() * settings.defaultIntensity;
+		}
+
+		return settings.defaultIntensity;
+	}
+
+	// Get the fraction of the default intensity for the lux sensor brightness, the curve is only evaluated when the sensor gives a new value
+	// and only moves once the brightness has moved past the deadband, and past the hysteresis as well if it has turned around
+	float
+	GetLuxIntensity(
+		void)
+	{
+		float	brightness = gOutdoorLighting->GetAvgBrightness();
+
+		if(luxValid && brightness == luxSample)
+		{
+			return luxIntensity;
+		}
+
+		luxSample = brightness;
+
+		if(luxValid)
+		{
+			float	delta = brightness - luxBrightness;
+			int8_t	direction = delta > 0.0f ? 1 : -1;
+			float	threshold = settings.luxDeadband + (luxDirection != 0 && direction != luxDirection ? settings.luxHysteresis : 0.0f);
+
+			if(fabsf(delta) <= threshold)
+			{
+				return luxIntensity;
+			}
+
+			luxDirection = direction;
+		}
+
+		luxValid = true;
+		luxBrightness = brightness;
+		luxIntensity = EvaluateLuxCurve(brightness);
+		AddTelemetry(eTelemetry_Lux, 0, uint16_t(brightness * 1000.0f + 0.5f), uint32_t(luxIntensity * 1000.0f + 0.5f));
+
+		return luxIntensity;
+	}
+
+	// Interpolate the lux curve at inBrightness and round it to the configured steps so the intensity only changes by a visible amount
+	float
+	EvaluateLuxCurve(
+		float	inBrightness)
+	{
+		float	pos = (inBrightness < 0.0f ? 0.0f : (inBrightness > 1.0f ? 1.0f : inBrightness)) * (eLuxCurvePoints - 1);
+		int		index = int(pos) < eLuxCurvePoints - 1 ? int(pos) : eLuxCurvePoints - 2;
+		float	fraction = pos - float(index);
+		float	result = settings.luxCurve[index] + (settings.luxCurve[index + 1] - settings.luxCurve[index]) * fraction;
+
+		if(settings.luxSteps != 0)
+		{
+			result = floorf(result * settings.luxSteps + 0.5f) / settings.luxSteps;
+		}
+
+		return result < 0.0f ? 0.0f : (result > 1.0f ? 1.0f : result);
+	}
+
+	// The time patterns are drawn at, a sync follower offsets its clock so it draws the same frames as the master
+	uint32_t
+	GetPatternTimeMS(
+		void)
+	{
+		return uint32_t(gCurLocalMS) + patternTimeOffsetMS;
+	}
+
+	// Apply the state sent by a sync master, the pattern is given by its index in gPatternList so both controllers need the same patterns
+	void
+	SyncStateReceived(
+		int			inPatternIndex,
+		uint32_t	inPatternTimeMS,
+		float		inIntensity)
+	{
+		// Relaying the state only ever delays it so the largest offset seen in a window is the closest to the master's clock
+		uint32_t	offsetMS = inPatternTimeMS - uint32_t(gCurLocalMS);
+
+		if(syncActive == false)
+		{
+			SystemMsg("Following sync master");
+			patternTimeOffsetMS = offsetMS;
+			syncTargetOffsetMS = offsetMS;
+			syncSlewMS = gCurLocalMS;
+			syncWindowStartMS = gCurLocalMS;
+			syncWindowOffsetMS = offsetMS;
+		}
+		else if(gCurLocalMS - syncWindowStartMS >= eSyncOffsetWindowMS)
+		{
+			// A smaller offset than the one in use is slewed to by SlewSyncOffset()
+			syncTargetOffsetMS = syncWindowOffsetMS;
+			syncWindowStartMS = gCurLocalMS;
+			syncWindowOffsetMS = offsetMS;
+		}
+		else if(int32_t(offsetMS - syncWindowOffsetMS) > 0)
+		{
+			syncWindowOffsetMS = offsetMS;
+		}
+
+		// A larger offset only moves pattern time forward so it is applied straight away
+		if(int32_t(offsetMS - syncTargetOffsetMS) > 0)
+		{
+			syncTargetOffsetMS = offsetMS;
+		}
+		if(int32_t(syncTargetOffsetMS - patternTimeOffsetMS) > 0)
+		{
+			patternTimeOffsetMS = syncTargetOffsetMS;
+		}
+
+		syncActive = true;
+		syncLastMS = gCurLocalMS;
+		syncIntensity = inIntensity;
+		Wake();
+
+		CBasePattern*	pattern = GetEnabledPattern(inPatternIndex);
+		if(pattern != basePattern)
+		{
+			basePattern = pattern;
+			SystemMsg("Sync pattern %s", basePattern == NULL ? "None" : basePattern->GetName());
+		}
+	}
+
+	// Move the pattern time offset back towards a smaller target without ever moving pattern time backwards
+	void
+	SlewSyncOffset(
+		void)
+	{
+		uint32_t	behindMS = patternTimeOffsetMS - syncTargetOffsetMS;
+
+		if(int32_t(behindMS) <= 0)
+		{
+			syncSlewMS = gCurLocalMS;
+			return;
+		}
+
+		// Local time advances eSyncSlewRate ms for every ms taken off the offset, the remainder carries over to the next update
+		uint32_t	stepMS = uint32_t(gCurLocalMS - syncSlewMS) / eSyncSlewRate;
+
+		if(stepMS > behindMS)
+		{
+			stepMS = behindMS;
+		}
+		patternTimeOffsetMS -= stepMS;
+		syncSlewMS += stepMS * eSyncSlewRate;
+	}
+
+	// Go back to using the local pattern, clock and intensity
+	void
+	StopSync(
+		void)
+	{
+		SystemMsg("Sync stopped");
+		syncActive = false;
+		patternTimeOffsetMS = 0;
+		FindBasePattern();
+	}
+
+	// Render the current view mode into outputFrame
+	void
+	RenderFrame(
+		uint32_t	inDeltaTimeUS)
+	{
+		// Only stream and sequence frames are limited as they are blit, the others are limited through outputLUT
+		if(rawPowerScale != 256 && viewMode != eViewMode_Stream && viewMode != eViewMode_Sequence)
+		{
+			rawPowerScale = 256;
+			outputDirty.Add(0, eLEDCount);
+		}
+
+		switch(viewMode)
+		{
+			case eViewMode_Normal:
+			{
+				float		intensity = syncActive ? syncIntensity : GetTargetIntensity();
+				uint16_t	scale = IntensityToScale(FadeIntensity(intensity, inDeltaTimeUS));
+				SPixelSpan	patternDirty;
+				uint32_t	perfStart = GetCycleCount();
+
+				UpdateLayers();
+				if(DrawFusedPattern(scale))
+				{
+					AddPerfTime(ePerfStage_Draw, perfStart);
+					break;
+				}
+
+				DrawBasePattern(patternDirty);
+				AddPerfTime(ePerfStage_Draw, perfStart);
+
+				// The layers are composited over the frame buffer as it is quantized
+				perfStart = GetCycleCount();
+				QuantizeFrame(scale, patternDirty);
+				AddPerfTime(ePerfStage_Scale, perfStart);
+				break;
+			}
+
+			case eViewMode_CyclePatterns:
+				if(gCurLocalMS - cyclePatternTimeMS >= eCyclePatternTime || basePattern == NULL)
+				{
+					// The built in patterns are always enabled so this finds one
+					do
+					{
+						basePattern = gPatternList[cyclePatternCount++ % gPatternCount];
+					} while(basePattern->IsEnabled() == false);
+					cyclePatternTimeMS = gCurLocalMS;
+				}
+				{
+					SPixelSpan	patternDirty;
+					uint32_t	perfStart = GetCycleCount();
+
+					UpdateLayers();
+					if(DrawFusedPattern(256))
+					{
+						AddPerfTime(ePerfStage_Draw, perfStart);
+						break;
+					}
+
+					DrawBasePattern(patternDirty);
+					AddPerfTime(ePerfStage_Draw, perfStart);
+
+					perfStart = GetCycleCount();
+					QuantizeFrame(256, patternDirty);
+					AddPerfTime(ePerfStage_Scale, perfStart);
+				}
+				break;
+
+			case eViewMode_TestPattern:
+			{
+				uint32_t	perfStart = GetCycleCount();
+
+				testPatternValue += cTestPatternPixelsPerSec * (float)inDeltaTimeUS / 1000000.0f;
+
+				if(testPatternValue >= eLEDCount * 2.0f)
+				{
+					testPatternValue -= eLEDCount * 2.0f;
+				}
+
+				int	intValue = (int)testPatternValue;
+				int	indexR = intValue <  eLEDCount ? intValue : eLEDCount * 2 - intValue - 1;
+				int	indexG = (intValue - 1) <  eLEDCount ? (intValue - 1) : eLEDCount * 2 - (intValue - 1);
+				int	indexB = (intValue - 2) <  eLEDCount ? (intValue - 2)  : eLEDCount * 2 - (intValue - 2) ;
+
+				for(int itr = 0; itr < eLEDCount; ++itr)
+				{
+					uint8_t	r, g, b;
+				
+					r = uint8_t(indexR == itr ? 0xFF : 0);
+					g = uint8_t(indexG == itr ? 0xFF : 0);
+					b = uint8_t(indexB == itr ? 0xFF : 0);
+					SetRoofPixel(itr, r, g, b);
+				}
+				AddPerfTime(ePerfStage_Draw, perfStart);
+				break;
+			}
+
+			case eViewMode_Stream:
+				// Stream packets write outputFrame as they arrive
+				break;
+
+			case eViewMode_Sequence:
+			{
+				uint32_t	perfStart = GetCycleCount();
+				uint32_t	frame = uint32_t((gCurLocalMS - sequenceStartMS) / sequencePlayer.GetFramePeriodMS() % sequencePlayer.GetFrameCount());
+				uint32_t	readFrame = frame;
+				uint8_t const*	rgb = sequencePlayer.GetFrame(frame, readFrame);
+
+				if(rgb == NULL || readFrame != frame)
+				{
+					// The frame has not been read yet so the last frame read stays up rather than waiting on the sd card
+					++sequenceLateFrames;
+				}
+				if(rgb != NULL && readFrame != sequenceShownFrame)
+				{
+					sequenceShownFrame = readFrame;
+					for(int itr = 0; itr < eLEDCount; ++itr, rgb += 3)
+					{
+						SetRoofPixel(itr, rgb[0], rgb[1], rgb[2]);
+					}
+					UpdateRawPowerLimit();
+				}
+				AddPerfTime(ePerfStage_Draw, perfStart);
+				break;
+			}
+		}
+	}
+
+	// Copy the changed part of outputFrame into the octo drawing memory and start the DMA transfer if the previous one has finished
+	void
+	ShowFrame(
+		bool	inForce)
+	{
+		if(outputDirty.IsEmpty() == false)
+		{
+			// The drawing memory is not touched by DMA so it is always safe to write
+			uint32_t	perfStart = GetCycleCount();
+			BlitFrame(outputDirty.start, outputDirty.end);
+			AddPerfTime(ePerfStage_Blit, perfStart);
+			outputDirty.Clear();
+			showPending = true;
+		}
+
+		// Only start a new DMA transfer when at least one led has a new value
+		if(showPending == false && inForce == false)
+		{
+			return;
+		}
+
+		// Never wait on the previous transfer, the frame stays pending and is sent on a later update
+		if(leds.busy())
+		{
+			showPending = true;
+			++frameStats.framesDropped;
+			return;
+		}
+
+		uint32_t	perfStart = GetCycleCount();
+		leds.show();
+		AddPerfTime(ePerfStage_Show, perfStart);
+		showPending = false;
+		++frameStats.framesShown;
+
+		if(bootFrameUS == 0)
+		{
+			// The first frame is on the leds once its transfer finishes
+			bootFrameUS = micros() + eFrameTransferUS;
+		}
+
+		if(motionResponsePending)
+		{
+			// The frame is on the leds once its DMA transfer finishes, the transfer time only depends on the strip length
+			uint32_t	latencyUS = micros() - motionCallbackUS + eFrameTransferUS;
+
+			motionResponsePending = false;
+			++motionStats.responses;
+			AddTelemetry(eTelemetry_MotionShown, 0, 0, latencyUS);
+			motionStats.lastUS = latencyUS;
+			motionStats.totalUS += latencyUS;
+			if(latencyUS > motionStats.maxUS)
+			{
+				motionStats.maxUS = latencyUS;
+			}
+		}
+	}
+
+	// Write the logical leds [inStart, inEnd) to the octo display memory a strip offset at a time
+	// Every offset the range touches on any segment is rewritten for all strips at once, so there is no per bit read-modify-write,
+	// and since the segments meet at the center of the house a change there only touches the first few offsets
+	void
+	BlitFrame(
+		int	inStart,
+		int	inEnd)
+	{
+		int	offsetStart = eLEDsPerStrip;
+		int	offsetEnd = 0;
+		int	segmentStart = 0;
+
+		// Find the union of the strip offsets the range covers on each segment
+		for(int segmentItr = 0; segmentItr < cLEDSegmentCount; ++segmentItr)
+		{
+			SLEDSegment const&	segment = cLEDLayout[segmentItr];
+			int					segmentEnd = segmentStart + segment.ledCount;
+			int					start = inStart > segmentStart ? inStart : segmentStart;
+			int					end = inEnd < segmentEnd ? inEnd : segmentEnd;
+
+			if(start < end)
+			{
+				int	firstOffset = segment.reversed ? segment.stripOffset + segmentEnd - end : segment.stripOffset + start - segmentStart;
+
+				if(firstOffset < offsetStart)
+				{
+					offsetStart = firstOffset;
+				}
+				if(firstOffset + end - start > offsetEnd)
+				{
+					offsetEnd = firstOffset + end - start;
+				}
+			}
+
+			segmentStart = segmentEnd;
+		}
+
+		uint8_t*	planes = (uint8_t*)gLEDDrawingMemory + offsetStart * eBytesPerLED;
+
+		for(int offset = offsetStart; offset < offsetEnd; ++offset, planes += eBytesPerLED)
+		{
+			// Gather the color components of the led at this offset on each strip, strips without one stay black
+			uint8_t	channels[3][eOctoStripCount];
+
+			memset(channels, 0, sizeof(channels));
+			segmentStart = 0;
+			for(int segmentItr = 0; segmentItr < cLEDSegmentCount; ++segmentItr)
+			{
+				SLEDSegment const&	segment = cLEDLayout[segmentItr];
+				int					segmentOffset = offset - segment.stripOffset;
+
+				if(segmentOffset >= 0 && segmentOffset < segment.ledCount)
+				{
+					SRGBPixel const&	pixel = outputFrame[segmentStart + (segment.reversed ? segment.ledCount - 1 - segmentOffset : segmentOffset)];
+
+					if(rawPowerScale == 256)
+					{
+						channels[0][segment.strip] = pixel.r;
+						channels[1][segment.strip] = pixel.g;
+						channels[2][segment.strip] = pixel.b;
+					}
+					else
+					{
+						channels[0][segment.strip] = uint8_t((pixel.r * rawPowerScale) >> 8);
+						channels[1][segment.strip] = uint8_t((pixel.g * rawPowerScale) >> 8);
+						channels[2][segment.strip] = uint8_t((pixel.b * rawPowerScale) >> 8);
+					}
+				}
+
+				segmentStart += segment.ledCount;
+			}
+
+			TransposeBitPlanes(channels[0], planes);
+			TransposeBitPlanes(channels[1], planes + 8);
+			TransposeBitPlanes(channels[2], planes + 16);
+		}
+	}
+
+	// Transpose one color component of the 8 strips into its 8 octo bit plane bytes, plane 0 holds the msb with strip n in bit n
+	// This is the 8x8 bit matrix transpose from Hacker's Delight done in two 32 bit words with strip 7 as the top row
+	static inline void
+	TransposeBitPlanes(
+		uint8_t const*	inValues,
+		uint8_t*		outPlanes)
+	{
+		uint32_t	x = (uint32_t(inValues[7]) << 24) | (uint32_t(inValues[6]) << 16) | (uint32_t(inValues[5]) << 8) | inValues[4];
+		uint32_t	y = (uint32_t(inValues[3]) << 24) | (uint32_t(inValues[2]) << 16) | (uint32_t(inValues[1]) << 8) | inValues[0];
+		uint32_t	t;
+
+		// Swap the off diagonal bits of each 2x2, then each 2x2 block of every 4x4, then the 4x4 blocks between the words
+		t = (x ^ (x >> 7)) & 0x00AA00AA;
+		x = x ^ t ^ (t << 7);
+		t = (y ^ (y >> 7)) & 0x00AA00AA;
+		y = y ^ t ^ (t << 7);
+		t = (x ^ (x >> 14)) & 0x0000CCCC;
+		x = x ^ t ^ (t << 14);
+		t = (y ^ (y >> 14)) & 0x0000CCCC;
+		y = y ^ t ^ (t << 14);
+		t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+		y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+		x = t;
+
+		outPlanes[0] = uint8_t(x >> 24);
+		outPlanes[1] = uint8_t(x >> 16);
+		outPlanes[2] = uint8_t(x >> 8);
+		outPlanes[3] = uint8_t(x);
+		outPlanes[4] = uint8_t(y >> 24);
+		outPlanes[5] = uint8_t(y >> 16);
+		outPlanes[6] = uint8_t(y >> 8);
+		outPlanes[7] = uint8_t(y);
+	}
+
+	// Draw the base pattern (or the default color if there is none) into the frame buffer if its content is out of date, outDirty is set to the range of the frame buffer that changed
+	void
+	DrawBasePattern(
+		SPixelSpan&	outDirty)
+	{
+		bool	fullRedraw = frameBufferValid == false || basePattern != drawnPattern || fusedPattern != NULL;
+
+		outDirty.Clear();
+		fusedPattern = NULL;
+
+		if(fullRedraw == false && (basePattern == NULL || basePattern->IsAnimated() == false))
+		{
+			return;
+		}
+
+		if(basePattern != NULL)
+		{
+			SPatternFrame	patternFrame;
+
+			patternFrame.timeMS = GetPatternTimeMS();
+			patternFrame.deltaTimeUS = uint32_t(patternFrame.timeMS - lastPatternTimeMS) * 1000;
+			patternFrame.fullRedraw = fullRedraw;
+			patternFrame.dirty.Clear();
+			basePattern->Draw(patternFrame, eLEDCount, frameBuffer);
+			outDirty = patternFrame.dirty;
+			lastPatternTimeMS = patternFrame.timeMS;
+		}
+		else
+		{
+			SPixel	defaultPixel;
+
+			SetPixelColor(defaultPixel, settings.defaultColor.r, settings.defaultColor.g, settings.defaultColor.b);
+			for(uint32_t itr = 0; itr < eLEDCount; ++itr)
+			{
+				frameBuffer[itr] = defaultPixel;
+			}
+			outDirty.Add(0, eLEDCount);
+		}
+
+		drawnPattern = basePattern;
+		frameBufferValid = true;
+	}
+
+	// Draw the base pattern with its fused kernel straight into outputFrame at inScale, this skips the frame buffer and the separate quantize pass
+	// Return false if the pattern has no kernel or dithering is on, dithering needs the unrounded value of every pixel so it always uses the frame buffer
+	bool
+	DrawFusedPattern(
+		uint16_t	inScale)
+	{
+		if(settings.dither != 0 || activeLayerCount != 0 || basePattern == NULL || basePattern->CanDrawOutput() == false)
+		{
+			return false;
+		}
+
+		uint16_t	scale = GetLimitedScale(inScale);
+		bool		fullRedraw = frameBufferValid == false || basePattern != fusedPattern || scale != outputScale;
+
+		if(fullRedraw == false && basePattern->IsAnimated() == false)
+		{
+			// The budget may have changed without the output changing
+			UpdatePowerLimit();
+			return true;
+		}
+
+		if(scale != outputScale)
+		{
+			BuildOutputLUT(scale);
+		}
+
+		SPatternFrame	patternFrame;
+		SOutputStage	stage = {outputLUT, outputFrame, &outputSum, &outputDirty};
+
+		patternFrame.timeMS = GetPatternTimeMS();
+		patternFrame.deltaTimeUS = uint32_t(patternFrame.timeMS - lastPatternTimeMS) * 1000;
+		patternFrame.fullRedraw = fullRedraw;
+		patternFrame.dirty.Clear();
+		basePattern->DrawOutput(patternFrame, eLEDCount, stage);
+		lastPatternTimeMS = patternFrame.timeMS;
+
+		outputScale = scale;
+		fusedPattern = basePattern;
+		frameBufferValid = true;
+		UpdatePowerLimit();
+
+		return true;
+	}
+
+	// Find the span of every layer for this frame and remove the layers that have run their duration
+	// Each layer's old and new span go into layerDirty so only the leds a layer touched are composited again
+	void
+	UpdateLayers(
+		void)
+	{
+		uint32_t	nowMS = uint32_t(gCurLocalMS);
+
+		activeLayerCount = 0;
+		for(int itr = 0; itr < eMaxLayers; ++itr)
+		{
+			SLayer&	layer = layers[itr];
+
+			layerDirty[itr] = layer.span;
+			layer.span.Clear();
+
+			if(layer.effect == NULL)
+			{
+				continue;
+			}
+
+			layer.elapsedMS = nowMS - layer.startMS;
+			if(layer.durationMS != 0 && layer.elapsedMS >= layer.durationMS)
+			{
+				layer.effect = NULL;
+				continue;
+			}
+
+			layer.effect->Prepare(layer);
+			if(layer.span.IsEmpty() == false)
+			{
+				layerDirty[itr].Add(layer.span.start, layer.span.end);
+			}
+			++activeLayerCount;
+		}
+	}
+
+	// Put a layer in a free slot and return the slot, -1 if there is none free
+	int
+	AddLayer(
+		CLayerEffect*	inEffect,
+		uint8_t			inBlend,
+		SPixel const&	inColor,
+		int				inFirstLED,
+		int				inLEDCount,
+		uint32_t		inPeriodMS,
+		uint32_t		inDurationMS,
+		uint32_t		inParam)
+	{
+		for(int itr = 0; itr < eMaxLayers; ++itr)
+		{
+			SLayer&	layer = layers[itr];
+
+			if(layer.effect != NULL)
+			{
+				continue;
+			}
+
+			// The span is kept so the leds a freed layer covered are still cleared
+			layer.effect = inEffect;
+			layer.blend = inBlend;
+			layer.color = inColor;
+			layer.firstLED = inFirstLED;
+			layer.ledCount = inLEDCount;
+			layer.periodMS = inPeriodMS;
+			layer.durationMS = inDurationMS;
+			layer.param = inParam;
+			layer.startMS = uint32_t(gCurLocalMS);
+			layer.elapsedMS = 0;
+			layer.state = 0;
+			Wake();
+
+			return itr;
+		}
+
+		return -1;
+	}
+
+	// Move the current intensity towards inTarget at the rate set by settings.fadeTimeMS and return it
+	float
+	FadeIntensity(
+		float		inTarget,
+		uint32_t	inDeltaTimeUS)
+	{
+		if(settings.fadeTimeMS == 0)
+		{
+			currentIntensity = inTarget;
+			return currentIntensity;
+		}
+
+		float	step = float(inDeltaTimeUS) / (float(settings.fadeTimeMS) * 1000.0f);
+
+		if(currentIntensity < inTarget)
+		{
+			currentIntensity = currentIntensity + step < inTarget ? currentIntensity + step : inTarget;
+		}
+		else if(currentIntensity > inTarget)
+		{
+			currentIntensity = currentIntensity - step > inTarget ? currentIntensity - step : inTarget;
+		}
+
+		return currentIntensity;
+	}
+
+	// Build the table that maps a linear value in 1/1020 steps to the gamma corrected output in 8.8 fixed point
+	// This uses float math so it is only done when the gamma setting changes
+	void
+	BuildGammaCurve(
+		void)
+	{
+		float	gamma = settings.gamma > 0.0f ? settings.gamma : 1.0f;
+
+		for(int itr = 0; itr < eGammaCurveSize; ++itr)
+		{
+			gammaCurve[itr] = uint16_t(powf(float(itr) / float(eGammaCurveSize - 1), gamma) * 65280.0f + 0.5f);
+		}
+		outputScale = eInvalidScale;
+	}
+
+	uint32_t
+	GetFramePeriodUS(
+		void)
+	{
+		// A period below the minimum can only come from settings saved by an older version
+		if(settings.framePeriodUS == 0 || settings.framePeriodUS < eMinFramePeriodUS)
+		{
+			return eDefaultFramePeriodUS;
+		}
+
+		return settings.framePeriodUS;
+	}
+
+	// Build the per channel output tables for the given intensity scale from the gamma curve and the color balance
+	void
+	BuildOutputLUT(
+		uint16_t	inScale)
+	{
+		float const*	balance = &settings.colorBalance.r;
+
+		for(int channelItr = 0; channelItr < 3; ++channelItr)
+		{
+			float		channelBalance = balance[channelItr] < 0.0f ? 0.0f : (balance[channelItr] > 1.0f ? 1.0f : balance[channelItr]);
+			uint32_t	channelScale = uint32_t(inScale * channelBalance + 0.5f);
+
+			for(int itr = 0; itr < 256; ++itr)
+			{
+				outputLUT[channelItr][itr] = gammaCurve[(itr * channelScale) >> 6];
+			}
+		}
+	}
+
+	// Scale the frame buffer into the leds, only inDirty is requantized unless the scale has changed
+	// The scale, color balance and gamma are applied through lookup tables that are only rebuilt when the scale changes so each step of a fade costs one table build
+	void
+	QuantizeFrame(
+		uint16_t			inScale,
+		SPixelSpan const&	inDirty)
+	{
+		int			start = inDirty.start;
+		int			end = inDirty.end;
+		uint16_t	scale = GetLimitedScale(inScale);
+
+		if(scale != outputScale)
+		{
+			BuildOutputLUT(scale);
+			start = 0;
+			end = eLEDCount;
+		}
+
+		if(settings.dither != 0)
+		{
+			// The dithered output changes every frame
+			for(int itr = 0; itr < eLEDCount; ++itr)
+			{
+				SRGBPixel	pixel;
+				SPixel		composed;
+
+				ComposePixel(itr, composed);
+				DitherPixel(composed, outputLUT, ditherError[itr], pixel);
+				SetRoofPixel(itr, pixel.r, pixel.g, pixel.b);
+			}
+		}
+		else
+		{
+			QuantizeRange(start, end);
+
+			if(start > 0 || end < eLEDCount)
+			{
+				for(int itr = 0; itr < eMaxLayers; ++itr)
+				{
+					if(layerDirty[itr].IsEmpty() == false)
+					{
+						QuantizeRange(layerDirty[itr].start, layerDirty[itr].end);
+					}
+				}
+			}
+		}
+		outputScale = scale;
+
+		// SetRoofPixel kept outputSum current as the frame was quantized so the limit for the next frame costs nothing to find
+		UpdatePowerLimit();
+	}
+
+	// Scale the pixels in [inStart, inEnd) into the leds with the layers composited over them
+	void
+	QuantizeRange(
+		int	inStart,
+		int	inEnd)
+	{
+		if(activeLayerCount == 0)
+		{
+			for(int itr = inStart; itr < inEnd; ++itr)
+			{
+				SRGBPixel	pixel;
+
+				ScalePixel(frameBuffer[itr], outputLUT, pixel);
+				SetRoofPixel(itr, pixel.r, pixel.g, pixel.b);
+			}
+			return;
+		}
+
+		for(int itr = inStart; itr < inEnd; ++itr)
+		{
+			SRGBPixel	pixel;
+			SPixel		composed;
+
+			ComposePixel(itr, composed);
+			ScalePixel(composed, outputLUT, pixel);
+			SetRoofPixel(itr, pixel.r, pixel.g, pixel.b);
+		}
+	}
+
+	// Get a frame buffer pixel with every layer that covers it composited over it in slot order
+	void
+	ComposePixel(
+		int		inIndex,
+		SPixel&	outPixel)
+	{
+		outPixel = frameBuffer[inIndex];
+
+		for(int itr = 0; itr < eMaxLayers; ++itr)
+		{
+			SLayer const&	layer = layers[itr];
+
+			if(layer.effect != NULL && inIndex >= layer.span.start && inIndex < layer.span.end)
+			{
+				BlendLayerPixel(layer.blend, layer.color, layer.effect->GetCoverage(layer, inIndex), outPixel);
+			}
+		}
+	}
+
+	// Apply the power limit to an intensity scale
+	uint16_t
+	GetLimitedScale(
+		uint16_t	inScale)
+	{
+		return uint16_t((inScale * uint32_t(powerLimitScale) + 128) >> 8);
+	}
+
+	// Get the current of one fully on led channel
+	uint32_t
+	GetChannelMA(
+		void)
+	{
+		return settings.channelMA == 0 ? uint32_t(eDefaultChannelMA) : settings.channelMA;
+	}
+
+	// Get the current the leds draw showing outputFrame
+	uint32_t
+	GetEstimatedMA(
+		void)
+	{
+		return uint32_t(uint64_t(outputSum) * rawPowerScale / 256 * GetChannelMA() / 255) + eLEDCount * eLEDIdleMA;
+	}
+
+	// Find the scale BlitFrame applies to stream and sequence frames, these are written to outputFrame as sent rather than quantized through outputLUT
+	// The led current is linear in the output values so the scale that fits the frame into the budget is found exactly and applies to the frame it was found from
+	void
+	UpdateRawPowerLimit(
+		void)
+	{
+		uint16_t	scale = 256;
+
+		if(settings.powerBudgetMA != 0)
+		{
+			uint32_t	idleMA = eLEDCount * eLEDIdleMA;
+			uint32_t	availableMA = settings.powerBudgetMA > idleMA ? settings.powerBudgetMA - idleMA : 0;
+			uint64_t	variableMA = uint64_t(outputSum) * GetChannelMA() / 255;
+
+			if(variableMA > availableMA)
+			{
+				scale = uint16_t(uint64_t(availableMA) * 256 / variableMA);
+			}
+		}
+
+		if(scale != rawPowerScale)
+		{
+			// Every led is scaled so the whole frame is blit again
+			rawPowerScale = scale;
+			if(ledsOn)
+			{
+				outputDirty.Add(0, eLEDCount);
+			}
+		}
+	}
+
+	// Find the power limit scale that brings the current of the frame just quantized into the budget, this takes effect on the next frame
+	void
+	UpdatePowerLimit(
+		void)
+	{
+		if(settings.powerBudgetMA == 0)
+		{
+			powerLimitScale = 256;
+			return;
+		}
+
+		uint32_t	idleMA = eLEDCount * eLEDIdleMA;
+		uint32_t	availableMA = settings.powerBudgetMA > idleMA ? settings.powerBudgetMA - idleMA : 0;
+		uint32_t	variableMA = GetEstimatedMA() - idleMA;
+		uint32_t	proposed;
+
+		if(variableMA == 0)
+		{
+			// A black frame says nothing about how bright the pattern can be
+			proposed = availableMA > 0 ? 256 : 0;
+		}
+		else
+		{
+			// The output is roughly the scale raised to the gamma so the scale moves by the inverse gamma of the current ratio
+			float	gamma = settings.gamma > 0.0f ? settings.gamma : 1.0f;
+			float	scale = powerLimitScale * powf(float(availableMA) / float(variableMA), 1.0f / gamma);
+
+			proposed = scale >= 256.0f ? 256 : uint32_t(scale);
+		}
+
+		if(proposed < powerLimitScale || proposed >= uint32_t(powerLimitScale) + ePowerLimitHysteresis || proposed == 256)
+		{
+			powerLimitScale = uint16_t(proposed);
+		}
+	}
+
+	// Force the frame buffer to be redrawn and requantized on the next update, call this whenever anything that affects the frame content changes
+	void
+	InvalidateFrame(
+		void)
+	{
+		frameBufferValid = false;
+		outputScale = eInvalidScale;
+		Wake();
+	}
+
+	void
+	SetRoofPixel(
+		int		inIndex,	// 0 is left side facing house, max led index is right side facing house
+		uint8_t	inRed,
+		uint8_t	inGreen,
+		uint8_t	inBlue)
+	{
+		SRGBPixel	value = {inRed, inGreen, inBlue};
+
+		WriteOutputPixel(outputFrame[inIndex], inIndex, value, outputSum, outputDirty);
+	}
+
+	uint8_t
+	TestPattern(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
+	{
+		if(inArgC != 2)
+		{
+			return eCmd_Failed;
+		}
+
+		if(strcmp(inArgv[1], "on") == 0)
+		{
+			gOutdoorLighting->SetOverride(true, true);
+			viewMode = eViewMode_TestPattern;
+			InvalidateFrame();
+			return true;
+		}
+		else if(strcmp(inArgv[1], "off") == 0)
+		{
+			gOutdoorLighting->SetOverride(false, false);
+			viewMode = eViewMode_Normal;
+			InvalidateFrame();
+			return true;
+		}
+
+		return eCmd_Succeeded;
+	}
+	
+	// Mark the settings as changed, they are saved to the eeprom once they have not changed for eSettingsSaveDelayMS
+	void
+	SettingsChanged(
+		void)
+	{
+		settingsDirty = true;
+		settingsChangedMS = gCurLocalMS;
+		statusPageValid = false;
+		Wake();
+	}
+
+	// Parse inValue into the setting described by inDesc in ioSettings, return false if the value is not valid
+	static bool
+	ParseSetting(
+		SSettingDesc const&	inDesc,
+		char const*			inValue,
+		SSettings&			ioSettings)
+	{
+		uint8_t*	field = (uint8_t*)&ioSettings + inDesc.offset;
+
+		for(int itr = 0; itr < inDesc.count; ++itr)
+		{
+			char*	end;
+
+			switch(inDesc.type)
+			{
+				case eSettingType_Float:
+					((float*)field)[itr] = (float)strtod(inValue, &end);
+					break;
+
+				case eSettingType_UInt32:
+					((uint32_t*)field)[itr] = (uint32_t)strtoul(inValue, &end, 10);
+					break;
+
+				default:
+					((uint8_t*)field)[itr] = (uint8_t)strtoul(inValue, &end, 10);
+					break;
+			}
+
+			if(end == inValue || *end != (itr == inDesc.count - 1 ? '\0' : ','))
+			{
+				return false;
+			}
+
+			inValue = end + 1;
+		}
+
+		return true;
+	}
+
+	uint8_t
+	SetSettings(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
+	{
+		if(inArgC < 2)
+		{
+			return eCmd_Failed;
+		}
+
+		// All of the values are parsed into a copy so nothing changes if any of them are not valid
+		SSettings	newSettings = settings;
+		uint8_t		apply = 0;
+
+		for(int argItr = 1; argItr < inArgC; ++argItr)
+		{
+			char const*	equals = strchr(inArgv[argItr], '=');
+			size_t		nameLen = equals != NULL ? equals - inArgv[argItr] : 0;
+			int			descItr;
+
+			for(descItr = 0; descItr < int(sizeof(cSettingDescs) / sizeof(cSettingDescs[0])); ++descItr)
+			{
+				if(nameLen == strlen(cSettingDescs[descItr].name) && strncmp(inArgv[argItr], cSettingDescs[descItr].name, nameLen) == 0)
+				{
+					break;
+				}
+			}
+
+			if(descItr == int(sizeof(cSettingDescs) / sizeof(cSettingDescs[0])) || ParseSetting(cSettingDescs[descItr], equals + 1, newSettings) == false)
+			{
+				inOutput->printf("Bad setting %s\n", inArgv[argItr]);
+				return eCmd_Failed;
+			}
+
+			apply |= cSettingDescs[descItr].apply;
+		}
+
+		if(newSettings.framePeriodUS != 0 && newSettings.framePeriodUS < eMinFramePeriodUS)
+		{
+			inOutput->printf("The frame period must be at least %d us\n", eMinFramePeriodUS);
+			return eCmd_Failed;
+		}
+
+		// The new values apply to the next frame, the eeprom write happens later
+		settings = newSettings;
+
+		if(apply & eSettingApply_Frame)
+		{
+			InvalidateFrame();
+		}
+
+		if(apply & eSettingApply_Gamma)
+		{
+			BuildGammaCurve();
+		}
+
+		if((apply & eSettingApply_Lux) && luminosityInterface != NULL)
+		{
+			luminosityInterface->SetMinMaxLux(settings.minLux, settings.maxLux);
+		}
 
-		luminosityInterface = new CTSL2561Sensor(0x39, eGain_1X, eIntegrationTime_13_7ms);
-		if(!luminosityInterface->IsPresent())
+		if(apply & eSettingApply_LuxCurve)
+		{
+			luxValid = false;
+		}
+
+		SettingsChanged();
+
+		return eCmd_Succeeded;
+	}
+
+	// Load the user patterns from the settings into their slots
+	void
+	LoadUserPatterns(
+		void)
+	{
+		for(int itr = 0; itr < eUserPatternSlots; ++itr)
+		{
+			SUserPatternDesc&	desc = settings.userPatterns[itr];
+
+			if(desc.paletteCount == 0)
+			{
+				continue;
+			}
+
+			desc.name[sizeof(desc.name) - 1] = 0;
+			if(CUserPattern::IsValid(desc) == false)
+			{
+				SystemMsg("User pattern %d is not valid", itr);
+				memset(&desc, 0, sizeof(desc));
+				continue;
+			}
+
+			gUserPatterns[itr].Load(&desc);
+		}
+	}
+
+	// The user patterns changed so the holiday calendar and the current pattern need updating
+	void
+	UserPatternsChanged(
+		void)
+	{
+		holidayTableYear = 0;
+		if(ledsOn)
+		{
+			FindBasePattern();
+		}
+		InvalidateFrame();
+		SettingsChanged();
+	}
+
+	uint8_t
+	AddUserPattern(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
+	{
+		if(inArgC != 2)
+		{
+			return eCmd_Failed;
+		}
+
+		int	slot;
+		for(slot = 0; slot < eUserPatternSlots; ++slot)
+		{
+			if(settings.userPatterns[slot].paletteCount == 0)
+			{
+				break;
+			}
+		}
+
+		if(slot == eUserPatternSlots)
+		{
+			inOutput->printf("No free pattern slots\n");
+			return eCmd_Failed;
+		}
+
+		// Decode the hex into a zeroed descriptor
+		SUserPatternDesc	desc;
+		uint8_t*			descBytes = (uint8_t*)&desc;
+		char const*			hex = inArgv[1];
+		size_t				hexLen = strlen(hex);
+
+		memset(&desc, 0, sizeof(desc));
+		if((hexLen & 1) != 0 || hexLen / 2 > sizeof(desc))
+		{
+			return eCmd_Failed;
+		}
+
+		for(size_t itr = 0; itr < hexLen / 2; ++itr)
+		{
+			char	byteStr[3] = {hex[itr * 2], hex[itr * 2 + 1], 0};
+			char*	end;
+
+			descBytes[itr] = (uint8_t)strtoul(byteStr, &end, 16);
+			if(end != byteStr + 2)
+			{
+				return eCmd_Failed;
+			}
+		}
+
+		desc.name[sizeof(desc.name) - 1] = 0;
+		if(CUserPattern::IsValid(desc) == false)
+		{
+			inOutput->printf("Pattern is not valid\n");
+			return eCmd_Failed;
+		}
+
+		settings.userPatterns[slot] = desc;
+		gUserPatterns[slot].Load(&settings.userPatterns[slot]);
+		UserPatternsChanged();
+
+		inOutput->printf("%d\n", slot);
+
+		return eCmd_Succeeded;
+	}
+
+	uint8_t
+	RemoveUserPattern(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
+	{
+		if(inArgC != 2)
+		{
+			return eCmd_Failed;
+		}
+
+		int	slot = atoi(inArgv[1]);
+		if(slot < 0 || slot >= eUserPatternSlots || settings.userPatterns[slot].paletteCount == 0)
+		{
+			return eCmd_Failed;
+		}
+
+		// The slot stays in gPatternList disabled so the index of every other pattern is unchanged
+		if(basePattern == &gUserPatterns[slot])
+		{
+			basePattern = NULL;
+		}
+
+		memset(&settings.userPatterns[slot], 0, sizeof(settings.userPatterns[slot]));
+		gUserPatterns[slot].Load(NULL);
+		UserPatternsChanged();
+
+		return eCmd_Succeeded;
+	}
+
+	uint8_t
+	ListUserPatterns(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
+	{
+		for(int itr = 0; itr < eUserPatternSlots; ++itr)
+		{
+			SUserPatternDesc const&	desc = settings.userPatterns[itr];
+
+			if(desc.paletteCount == 0)
+			{
+				inOutput->printf("%d free\n", itr);
+				continue;
+			}
+
+			inOutput->printf("%d %s date=%d/%d days=%d scroll=%dms colors=%d runs=%d\n", itr, desc.name, desc.startMonth, desc.startDay, desc.dayCount, desc.scrollPeriod * eUserScrollStepMS, desc.paletteCount, desc.runCount);
+		}
+
+		return eCmd_Succeeded;
+	}
+
+	uint8_t
+	AddLayerCmd(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
+	{
+		if(inArgC != 8 && inArgC != 9)
+		{
+			return eCmd_Failed;
+		}
+
+		CLayerEffect*	effect = NULL;
+		for(int itr = 0; itr < gEffectCount; ++itr)
+		{
+			if(strcmp(inArgv[1], gEffectList[itr]->GetName()) == 0)
+			{
+				effect = gEffectList[itr];
+				break;
+			}
+		}
+
+		int	blend;
+		for(blend = 0; blend < eBlendCount; ++blend)
+		{
+			if(strcmp(inArgv[2], gBlendStr[blend]) == 0)
+			{
+				break;
+			}
+		}
+
+		char*		end;
+		uint32_t	rgb = (uint32_t)strtoul(inArgv[3], &end, 16);
+		int			firstLED = atoi(inArgv[4]);
+		int			ledCount = atoi(inArgv[5]);
+		uint32_t	periodMS = (uint32_t)atol(inArgv[6]);
+		uint32_t	durationMS = (uint32_t)atol(inArgv[7]);
+		uint32_t	param = inArgC == 9 ? (uint32_t)atol(inArgv[8]) : 0;
+
+		if(effect == NULL || blend == eBlendCount || strlen(inArgv[3]) != 6 || *end != '\0'
+			|| firstLED < 0 || ledCount <= 0 || firstLED + ledCount > eLEDCount || periodMS == 0)
+		{
+			return eCmd_Failed;
+		}
+
+		SPixel	color;
+
+		SetPixelRGB(color, uint8_t(rgb >> 16), uint8_t(rgb >> 8), uint8_t(rgb));
+
+		int	slot = AddLayer(effect, uint8_t(blend), color, firstLED, ledCount, periodMS, durationMS, param);
+		if(slot < 0)
+		{
+			inOutput->printf("No free layers\n");
+			return eCmd_Failed;
+		}
+
+		inOutput->printf("%d\n", slot);
+
+		return eCmd_Succeeded;
+	}
+
+	uint8_t
+	RemoveLayerCmd(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
+	{
+		if(inArgC != 2)
+		{
+			return eCmd_Failed;
+		}
+
+		int	slot = atoi(inArgv[1]);
+		if(slot < 0 || slot >= eMaxLayers || layers[slot].effect == NULL)
+		{
+			return eCmd_Failed;
+		}
+
+		// The leds it covered are cleared on the next frame
+		layers[slot].effect = NULL;
+		Wake();
+
+		return eCmd_Succeeded;
+	}
+
+	uint8_t
+	ListLayers(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
+	{
+		for(int itr = 0; itr < eMaxLayers; ++itr)
+		{
+			SLayer const&	layer = layers[itr];
+
+			if(layer.effect == NULL)
+			{
+				inOutput->printf("%d free\n", itr);
+				continue;
+			}
+
+			uint8_t	r, g, b;
+
+			GetPixelRGB(layer.color, r, g, b);
+			inOutput->printf("%d %s %s color=%02x%02x%02x leds=%d-%d period=%lums duration=%lums param=%lu\n", itr, layer.effect->GetName(), gBlendStr[layer.blend], r, g, b,
+				layer.firstLED, layer.firstLED + layer.ledCount - 1, (unsigned long)layer.periodMS, (unsigned long)layer.durationMS, (unsigned long)layer.param);
+		}
+
+		return eCmd_Succeeded;
+	}
+
+	// Get the index of the base pattern in gPatternList or -1 for the default color
+	int
+	GetBasePatternIndex(
+		void)
+	{
+		for(int itr = 0; itr < gPatternCount; ++itr)
+		{
+			if(gPatternList[itr] == basePattern)
+			{
+				return itr;
+			}
+		}
+
+		return -1;
+	}
+
+	uint8_t
+	GetSync(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
+	{
+		inOutput->printf("sync_set %d %lu %f\n", GetBasePatternIndex(), (unsigned long)GetPatternTimeMS(), syncActive ? syncIntensity : GetTargetIntensity());
+
+		return eCmd_Succeeded;
+	}
+
+	uint8_t
+	SetSync(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
+	{
+		if(inArgC != 4)
+		{
+			return eCmd_Failed;
+		}
+
+		SyncStateReceived(atoi(inArgv[1]), (uint32_t)strtoul(inArgv[2], NULL, 10), (float)atof(inArgv[3]));
+
+		return eCmd_Succeeded;
+	}
+
+	uint8_t
+	StopSyncCmd(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
+	{
+		if(syncActive)
+		{
+			StopSync();
+		}
+
+		return eCmd_Succeeded;
+	}
+
+	uint8_t
+	PlaySequence(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
+	{
+		if(inArgC != 2 && inArgC != 3)
+		{
+			return eCmd_Failed;
+		}
+
+		if(sdPresent == false || sequencePlayer.Open(inArgv[1]) == false)
+		{
+			inOutput->printf("Could not open %s\n", inArgv[1]);
+			return eCmd_Failed;
+		}
+
+		// Anchor the sequence to the wall clock so it plays in sync with the time of day
+		uint64_t	elapsedMS = 0;
+		if(inArgC == 3)
+		{
+			int	startHour = 0, startMin = 0, startSec = 0;
+			int	year, month, day, dow, hour, min, sec;
+
+			if(sscanf(inArgv[2], "%d:%d:%d", &startHour, &startMin, &startSec) < 2)
+			{
+				sequencePlayer.Close();
+				return eCmd_Failed;
+			}
+
+			gRealTime->GetComponentsFromEpochTime(gRealTime->GetEpochTime(false), year, month, day, dow, hour, min, sec);
+			elapsedMS = uint64_t(((hour - startHour) * 60 * 60 + (min - startMin) * 60 + (sec - startSec) + 24 * 60 * 60) % (24 * 60 * 60)) * 1000;
+		}
+
+		sequenceStartMS = gCurLocalMS - elapsedMS;
+		sequenceShownFrame = 0xFFFFFFFF;
+		sequenceLateFrames = 0;
+		viewMode = eViewMode_Sequence;
+		gOutdoorLighting->SetOverride(true, true);
+		Wake();
+
+		return eCmd_Succeeded;
+	}
+
+	uint8_t
+	StopSequence(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
+	{
+		if(viewMode == eViewMode_Sequence)
 		{
-			luminosityInterface = NULL;
+			viewMode = eViewMode_Normal;
+			InvalidateFrame();
+			gOutdoorLighting->SetOverride(false, false);
 		}
+		sequencePlayer.Close();
 
-		// Include dependent modules
+		return eCmd_Succeeded;
+	}
 
-		CModule_Loggly*			loggly = CModule_Loggly::Include("front_house");
-		IRealTimeDataProvider*	ds3234Provider = CreateDS3234Provider(eRTCChipSelect);
-		IRealTimeDataProvider*	networkProvider = CreateNTPProvider("2.us.pool.ntp.org", 123);
-		IInternetDevice*		internetDevice = CModule_ESP8266::Include(&Serial1, eESP8266ResetPin);
+	uint8_t
+	GetSequence(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
+	{
+		if(sequencePlayer.IsOpen() == false)
+		{
+			inOutput->printf("stopped\n");
+			return eCmd_Succeeded;
+		}
 
-		CModule_RealTime::Include();
-		CModule_Internet::Include();
-		CModule_Command::Include();
-		CModule_OutdoorLightingControl::Include(this, false, eMotionSensorPin, eTransformerRelayPin, eToggleButtonPin, luminosityInterface);
+		inOutput->printf("frame=%lu of %lu period=%lu ms late=%lu seeks=%lu errors=%lu\n", (unsigned long)sequenceShownFrame, (unsigned long)sequencePlayer.GetFrameCount(), (unsigned long)sequencePlayer.GetFramePeriodMS(),
+			(unsigned long)sequenceLateFrames, (unsigned long)sequencePlayer.seekCount, (unsigned long)sequencePlayer.readErrors);
 
-		AddSysMsgHandler(loggly);
-		gRealTime->Configure(ds3234Provider, networkProvider, 1 * 60 * 60);
-		gInternetModule->Configure(internetDevice);
-		ledsOn = false;
+		return eCmd_Succeeded;
 	}
 
-	void
-	Setup(
-		void)
+	uint8_t
+	StreamPacket(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
 	{
-		if(luminosityInterface != NULL)
+		if(inArgC != 6)
 		{
-			SystemMsg("Luminosity sensor present");
-			luminosityInterface->SetMinMaxLux(settings.minLux, settings.maxLux);
+			return eCmd_Failed;
 		}
-		else
+
+		char const*	hex = inArgv[5];
+		size_t		hexLen = strlen(hex);
+		int			ledCount = int(hexLen / 6);
+		uint8_t		rgb[eStreamMaxPacketLEDs * 3];
+
+		if(hexLen % 6 != 0 || ledCount > eStreamMaxPacketLEDs)
 		{
-			SystemMsg("Luminosity sensor missing");
+			return eCmd_Failed;
 		}
 
-		// Configure the time provider on the standard SPI chip select pin
-
-		// Instantiate the wireless networking device and configure it to serve pages
-		gInternetModule->WebServer_Start(8080);
-		MInternetRegisterPage("/", COutdoorLightingModule::CommandHomePageHandler);
+		for(int itr = 0; itr < ledCount * 3; ++itr)
+		{
+			char	byteStr[3] = {hex[itr * 2], hex[itr * 2 + 1], 0};
+			char*	end;
 
-		// Register the commands
-		MCommandRegister("test_pattern", COutdoorLightingModule::TestPattern, "");
-		MCommandRegister("color_set", COutdoorLightingModule::SetColor, "");
-		MCommandRegister("color_get", COutdoorLightingModule::GetColor, "");
-		MCommandRegister("intensity_set", COutdoorLightingModule::SetIntensity, "[default] [active] : set the intensity levels");
-		MCommandRegister("intensity_get", COutdoorLightingModule::GetIntensity, "");
-		MCommandRegister("luxminmax_set", COutdoorLightingModule::SetMinMaxLux, "");
-		MCommandRegister("luxminmax_get", COutdoorLightingModule::GetMinMaxLux, "");
+			rgb[itr] = (uint8_t)strtoul(byteStr, &end, 16);
+			if(end != byteStr + 2)
+			{
+				return eCmd_Failed;
+			}
+		}
 
-		leds.begin();
+		StreamPacketReceived((uint8_t)atoi(inArgv[1]), (uint32_t)strtoul(inArgv[2], NULL, 10), atoi(inArgv[3]), ledCount, rgb, (uint8_t)atoi(inArgv[4]));
 
-		viewMode = eViewMode_Normal;
+		return eCmd_Succeeded;
 	}
 
-	void
-	CommandHomePageHandler(
+	uint8_t
+	StreamCodecPacket(
 		IOutputDirector*	inOutput,
-		int					inParamCount,
-		char const**		inParamList)
+		int					inArgC,
+		char const*			inArgv[])
 	{
-		// Send html via in Output to add to the command server home page served to clients
-		inOutput->printf("<table border=\"1\">");
-		inOutput->printf("<tr><th>Parameter</th><th>Value</th></tr>");
-
-		// add current holiday
-		inOutput->printf("<tr><td>Holiday</td><td>%s</td></tr>", basePattern != NULL ? basePattern->GetName() : "None");
+		if(inArgC != 4)
+		{
+			return eCmd_Failed;
+		}
 
-		// add viewMode
-		inOutput->printf("<tr><td>View Mode</td><td>%s</td></tr>", gViewModeStr[viewMode]);
+		char const*	hex = inArgv[3];
+		size_t		hexLen = strlen(hex);
+		int			packetSize = int(hexLen / 2);
+		uint8_t		packet[eStreamMaxCodecPacketSize];
 
-		// add settings.defaultColor
-		inOutput->printf("<tr><td>Default Color</td><td>r:%01.02f g:%01.02f b:%01.02f</td></tr>", settings.defaultColor.r, settings.defaultColor.g, settings.defaultColor.b);
+		if(hexLen % 2 != 0 || packetSize > eStreamMaxCodecPacketSize)
+		{
+			return eCmd_Failed;
+		}
 
-		// add settings.defaultIntensity
-		inOutput->printf("<tr><td>Default Intensity</td><td>%01.02f</td></tr>", settings.defaultIntensity);
+		for(int itr = 0; itr < packetSize; ++itr)
+		{
+			char	byteStr[3] = {hex[itr * 2], hex[itr * 2 + 1], 0};
+			char*	end;
 
-		// add settings.activeIntensity
-		inOutput->printf("<tr><td>Active Intensity</td><td>%01.02f</td></tr>", settings.activeIntensity);
+			packet[itr] = (uint8_t)strtoul(byteStr, &end, 16);
+			if(end != byteStr + 2)
+			{
+				return eCmd_Failed;
+			}
+		}
 
-		// add settings.minLux, settings.maxLux
-		inOutput->printf("<tr><td>Lux Range</td><td>%f %f</td></tr>", settings.minLux, settings.maxLux);
+		StreamCodecPacketReceived((uint8_t)atoi(inArgv[1]), (uint32_t)strtoul(inArgv[2], NULL, 10), packet, packetSize);
 
-		inOutput->printf("</table>");
+		return eCmd_Succeeded;
 	}
 
-	virtual void
-	LEDStateChange(
-		bool	inLEDsOn)
+	uint8_t
+	GetStreamStats(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
 	{
-		ledsOn = inLEDsOn;
+		uint32_t	elapsedMS = uint32_t(gCurLocalMS - streamStats.startMS);
+		uint32_t	receivedCount = streamStats.packetsReceived + streamStats.packetsLost;
 
-		if(ledsOn == false)
+		inOutput->printf("packets=%lu lost=%lu dropped=%lu frames=%lu\n", (unsigned long)streamStats.packetsReceived, (unsigned long)streamStats.packetsLost, (unsigned long)streamStats.packetsDropped, (unsigned long)streamStats.framesReceived);
+		inOutput->printf("loss=%01.02f%% latency avg=%lu max=%lu ms\n", receivedCount > 0 ? streamStats.packetsLost * 100.0f / receivedCount : 0.0f,
+			(unsigned long)(streamStats.packetsReceived > 0 ? streamStats.totalLatencyMS / streamStats.packetsReceived : 0), (unsigned long)streamStats.maxLatencyMS);
+		if(elapsedMS > 0)
 		{
-			// turn all LEDs off
-			for(uint32_t itr = 0; itr < eLEDCount; ++itr)
-			{
-				SetRoofPixel(itr, 0, 0, 0);
-			}
-			leds.show();
+			inOutput->printf("fps=%01.02f bytes/s=%lu\n", streamStats.framesReceived * 1000.0f / elapsedMS, (unsigned long)(uint64_t(streamStats.bytesReceived) * 1000 / elapsedMS));
 		}
-		else
+		if(streamStats.bytesReceived > 0)
 		{
-			FindBasePattern();
+			// The size of sending every led of every frame over the bytes actually sent
+			inOutput->printf("compression=%01.01fx\n", streamStats.framesReceived * (eLEDCount * 3.0f) / streamStats.bytesReceived);
 		}
-	}
 
-	virtual void
-	MotionSensorStateChange(
-		bool	inMotionSensorTriggered)
-	{
-		motionSensorTriggered = inMotionSensorTriggered;
+		return eCmd_Succeeded;
 	}
 
-	virtual void
-	LuxSensorStateChange(
-		bool	inTriggered)
+	uint8_t
+	ResetStreamStats(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
 	{
+		uint8_t	nextSequence = streamStats.nextSequence;
+		int32_t	minClockOffsetMS = streamStats.minClockOffsetMS;
+
+		memset(&streamStats, 0, sizeof(streamStats));
+		streamStats.startMS = gCurLocalMS;
+		streamStats.nextSequence = nextSequence;
+		streamStats.minClockOffsetMS = minClockOffsetMS;
+
+		return eCmd_Succeeded;
 	}
 
-	virtual void
-	PushButtonStateChange(
-		int	inToggleCount)
+	uint8_t
+	SetColor(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
 	{
-		if(inToggleCount == ePushCount_CyclePatterns)
-		{
-			SystemMsg("Entering pattern cycling\n");
-			viewMode = eViewMode_CyclePatterns;
-			gOutdoorLighting->SetOverride(true, true);
-		}
-		else if(inToggleCount == ePushCount_TestPattern)
+		if(inArgC != 4)
 		{
-			SystemMsg("Entering test pattern\n");
-			viewMode = eViewMode_TestPattern;
-			gOutdoorLighting->SetOverride(true, true);
+			return eCmd_Failed;
 		}
-		else
+
+		settings.defaultColor.r = (float)atof(inArgv[1]);
+		settings.defaultColor.g = (float)atof(inArgv[2]);
+		settings.defaultColor.b = (float)atof(inArgv[3]);
+
+		SettingsChanged();
+		InvalidateFrame();
+
+		return eCmd_Succeeded;
+	}
+	
+	uint8_t
+	GetColor(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
+	{
+		inOutput->printf("%f %f %f\n", settings.defaultColor.r, settings.defaultColor.g, settings.defaultColor.b);
+
+		return eCmd_Succeeded;
+	}
+
+	uint8_t
+	SetIntensity(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
+	{
+		if(inArgC != 3)
 		{
-			SystemMsg("Entering normal mode\n");
-			viewMode = eViewMode_Normal;
-			gOutdoorLighting->SetOverride(false, false);
+			return eCmd_Failed;
 		}
+
+		settings.defaultIntensity = (float)atof(inArgv[1]);
+		settings.activeIntensity = (float)atof(inArgv[2]);
+
+		SettingsChanged();
+
+		return eCmd_Succeeded;
 	}
 
-	virtual void
-	TimeOfDayChange(
-		int	inTimeOfDay)
+	uint8_t
+	GetIntensity(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
 	{
-		timeOfDay = inTimeOfDay;
+		inOutput->printf("%f %f\n", settings.defaultIntensity, settings.activeIntensity);
+
+		return eCmd_Succeeded;
 	}
 
+	// Save the render state and turn off everything that makes a frame depend on more than the pattern, its time and the color settings
+	// Layers, fades, dithering, the power limit, sync, the boot state, motion and the lux sensor are left out
 	void
-	Update(
-		uint32_t inDeltaTimeUS)
+	SaveRenderState(
+		SRenderState&	outState)
 	{
-		if(ledsOn == false)
+		outState.viewMode = viewMode;
+		outState.basePattern = basePattern;
+		outState.currentIntensity = currentIntensity;
+		outState.testPatternValue = testPatternValue;
+		outState.cyclePatternTimeMS = cyclePatternTimeMS;
+		outState.cyclePatternCount = cyclePatternCount;
+		outState.frameTimeUS = frameTimeUS;
+		outState.frameDueUS = frameDueUS;
+		outState.lastPatternTimeMS = lastPatternTimeMS;
+		outState.patternTimeOffsetMS = patternTimeOffsetMS;
+		outState.timeOfDay = timeOfDay;
+		outState.motionSensorTriggered = motionSensorTriggered;
+		outState.syncActive = syncActive;
+		outState.bootStateShown = bootStateShown;
+		outState.luminosityInterface = luminosityInterface;
+		outState.powerLimitScale = powerLimitScale;
+		outState.rawPowerScale = rawPowerScale;
+		outState.dither = settings.dither;
+		outState.powerBudgetMA = settings.powerBudgetMA;
+		outState.fadeTimeMS = settings.fadeTimeMS;
+		memcpy(outState.layers, layers, sizeof(layers));
+		memcpy(outState.layerDirty, layerDirty, sizeof(layerDirty));
+		outState.activeLayerCount = activeLayerCount;
+
+		for(int itr = 0; itr < eMaxLayers; ++itr)
 		{
-			return;
+			layers[itr].effect = NULL;
+			layers[itr].span.Clear();
+			layerDirty[itr].Clear();
 		}
+		activeLayerCount = 0;
+		settings.dither = 0;
+		settings.powerBudgetMA = 0;
+		settings.fadeTimeMS = 0;
+		powerLimitScale = 256;
+		rawPowerScale = 256;
+		luminosityInterface = NULL;
+		syncActive = false;
+		bootStateShown = false;
+		motionSensorTriggered = false;
+		frameTimeUS = 0;
+		frameDueUS = 0;
+	}
 
-		switch(viewMode)
+	// Put back the state saved by SaveRenderState(), outputFrame and the drawing memory hold other frames now so the whole frame is sent again
+	void
+	RestoreRenderState(
+		SRenderState const&	inState)
+	{
+		viewMode = inState.viewMode;
+		basePattern = inState.basePattern;
+		currentIntensity = inState.currentIntensity;
+		testPatternValue = inState.testPatternValue;
+		cyclePatternTimeMS = inState.cyclePatternTimeMS;
+		cyclePatternCount = inState.cyclePatternCount;
+		frameTimeUS = inState.frameTimeUS;
+		frameDueUS = inState.frameDueUS;
+		lastPatternTimeMS = inState.lastPatternTimeMS;
+		patternTimeOffsetMS = inState.patternTimeOffsetMS;
+		timeOfDay = inState.timeOfDay;
+		motionSensorTriggered = inState.motionSensorTriggered;
+		syncActive = inState.syncActive;
+		bootStateShown = inState.bootStateShown;
+		luminosityInterface = inState.luminosityInterface;
+		powerLimitScale = inState.powerLimitScale;
+		rawPowerScale = inState.rawPowerScale;
+		settings.dither = inState.dither;
+		settings.powerBudgetMA = inState.powerBudgetMA;
+		settings.fadeTimeMS = inState.fadeTimeMS;
+		memcpy(layers, inState.layers, sizeof(layers));
+		memcpy(layerDirty, inState.layerDirty, sizeof(layerDirty));
+		activeLayerCount = inState.activeLayerCount;
+
+		InvalidateFrame();
+		outputDirty.Add(0, eLEDCount);
+		memset(perfFrame, 0, sizeof(perfFrame));
+	}
+
+	// Render inFrames frames of the current view mode into the drawing memory without starting a DMA transfer and return the average time per frame in ns
+	uint32_t
+	BenchmarkFrames(
+		int		inFrames,
+		bool	inFullRedraw)
+	{
+		uint32_t	startUS = micros();
+
+		for(int itr = 0; itr < inFrames; ++itr)
 		{
-			case eViewMode_Normal:
+			if(inFullRedraw)
 			{
-				if(basePattern != NULL)
-				{
-					basePattern->Draw(eLEDCount, frameBuffer);
-				}
-				else
-				{
-					for(uint32_t itr = 0; itr < eLEDCount; ++itr)
-					{
-						frameBuffer[itr].r = settings.defaultColor.r;
-						frameBuffer[itr].g = settings.defaultColor.g;
-						frameBuffer[itr].b = settings.defaultColor.b;
-					}
-				}
+				InvalidateFrame();
+			}
+
+			// Advance the frame time so animated patterns and the test pattern do real work
+			RenderFrame(GetFramePeriodUS());
+			if(outputDirty.IsEmpty() == false)
+			{
+				BlitFrame(outputDirty.start, outputDirty.end);
+				outputDirty.Clear();
+			}
+		}
 
-				float	intensity;
+		return uint32_t(uint64_t(micros() - startUS) * 1000 / inFrames);
+	}
 
-				if(timeOfDay == eTimeOfDay_Day)
-				{
-					intensity = 1.0;
-				}
-				else
-				{
-					if(motionSensorTriggered)
-					{
-						intensity = settings.activeIntensity;
-					}
-					else if(luminosityInterface != NULL)
-					{
-						intensity = (1.0f - gOutdoorLighting->GetAvgBrightness()) * settings.defaultIntensity;
-					}
-					else
-					{
-						intensity = settings.defaultIntensity;
-					}
-				}
+	void
+	PrintBenchmark(
+		IOutputDirector*	inOutput,
+		char const*			inName,
+		char const*			inMode,
+		uint32_t			inFullNS,
+		uint32_t			inSteadyNS)
+	{
+		inOutput->printf("%s %s full=%luns %luns/px steady=%luns %luns/px\n", inName, inMode, (unsigned long)inFullNS, (unsigned long)(inFullNS / eLEDCount), (unsigned long)inSteadyNS, (unsigned long)(inSteadyNS / eLEDCount));
+	}
+
+	uint8_t
+	Benchmark(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
+	{
+		int	frames = inArgC >= 2 ? atoi(inArgv[1]) : 100;
 
-				// Perhaps eventually apply some effects here
+		if(frames <= 0)
+		{
+			return eCmd_Failed;
+		}
 
-				for(uint32_t itr = 0; itr < eLEDCount; ++itr)
-				{
-					SetRoofPixel(itr, uint8_t(frameBuffer[itr].r * intensity * 255.0f), uint8_t(frameBuffer[itr].g * intensity * 255.0f), uint8_t(frameBuffer[itr].b * intensity * 255.0f));
-				}
-				break;
+		SRenderState	savedState;
+
+		SaveRenderState(savedState);
+
+		for(int patternItr = 0; patternItr < gPatternCount; ++patternItr)
+		{
+			basePattern = gPatternList[patternItr];
+			if(basePattern->IsEnabled() == false)
+			{
+				continue;
 			}
 
-			case eViewMode_CyclePatterns:
-				if(gCurLocalMS - cyclePatternTimeMS >= eCyclePatternTime || basePattern == NULL)
-				{
-					SystemMsg("Cycling patterns\n");
-					basePattern = gPatternList[cyclePatternCount++ % gPatternCount];
-					cyclePatternTimeMS = gCurLocalMS;
-				}
-				basePattern->Draw(eLEDCount, frameBuffer);
-				for(uint32_t itr = 0; itr < eLEDCount; ++itr)
-				{
-					SetRoofPixel(itr, int(frameBuffer[itr].r * 255.0f), int(frameBuffer[itr].g * 255.0f), int(frameBuffer[itr].b * 255.0f));
-				}
-				break;
+			viewMode = eViewMode_Normal;
+			uint32_t	fullNS = BenchmarkFrames(frames, true);
+			uint32_t	steadyNS = BenchmarkFrames(frames, false);
+			PrintBenchmark(inOutput, basePattern->GetName(), "normal", fullNS, steadyNS);
+
+			// Keep cycle mode on this pattern for the whole run
+			viewMode = eViewMode_CyclePatterns;
+			cyclePatternTimeMS = gCurLocalMS;
+			fullNS = BenchmarkFrames(frames, true);
+			steadyNS = BenchmarkFrames(frames, false);
+			PrintBenchmark(inOutput, basePattern->GetName(), "cycle", fullNS, steadyNS);
+		}
 
-			case eViewMode_TestPattern:
-				testPatternValue += cTestPatternPixelsPerSec * (float)inDeltaTimeUS / 1000000.0f;
+		viewMode = eViewMode_TestPattern;
+		uint32_t	fullNS = BenchmarkFrames(frames, true);
+		uint32_t	steadyNS = BenchmarkFrames(frames, false);
+		PrintBenchmark(inOutput, "Test", "test", fullNS, steadyNS);
 
-				if(testPatternValue >= eLEDCount * 2.0f)
-				{
-					testPatternValue -= eLEDCount * 2.0f;
-				}
+		RestoreRenderState(savedState);
 
-				int	intValue = (int)testPatternValue;
-				int	indexR = intValue <  eLEDCount ? intValue : eLEDCount * 2 - intValue - 1;
-				int	indexG = (intValue - 1) <  eLEDCount ? (intValue - 1) : eLEDCount * 2 - (intValue - 1);
-				int	indexB = (intValue - 2) <  eLEDCount ? (intValue - 2)  : eLEDCount * 2 - (intValue - 2) ;
+		return eCmd_Succeeded;
+	}
 
-				for(int itr = 0; itr < eLEDCount; ++itr)
-				{
-					uint8_t	r, g, b;
-				
-					r = uint8_t(indexR == itr ? 0xFF : 0);
-					g = uint8_t(indexG == itr ? 0xFF : 0);
-					b = uint8_t(indexB == itr ? 0xFF : 0);
-					SetRoofPixel(itr, r, g, b);
-				}
-				break;
+	uint8_t
+	GetPerf(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
+	{
+		for(int itr = 0; itr < ePerfStageCount; ++itr)
+		{
+			uint32_t	minUS, avgUS, maxUS;
+
+			perfRing[itr].GetStatsUS(minUS, avgUS, maxUS);
+			inOutput->printf("%s min=%lu avg=%lu max=%lu\n", gPerfStageStr[itr], (unsigned long)minUS, (unsigned long)avgUS, (unsigned long)maxUS);
 		}
 
-		leds.show();
+		return eCmd_Succeeded;
 	}
 
-	void
-	SetRoofPixel(
-		int		inIndex,	// 0 is left side facing house, max led index is right side facing house
-		uint8_t	inRed,
-		uint8_t	inGreen,
-		uint8_t	inBlue)
+	uint8_t
+	ResetPerf(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
 	{
-		leds.setPixel(gLEDMap[inIndex], inRed, inGreen, inBlue);
+		memset(perfRing, 0, sizeof(perfRing));
+		memset(perfFrame, 0, sizeof(perfFrame));
+
+		return eCmd_Succeeded;
 	}
 
 	uint8_t
-	TestPattern(
+	SetFadeTime(
 		IOutputDirector*	inOutput,
 		int					inArgC,
 		char const*			inArgv[])
@@ -719,79 +4900,146 @@ private:
 			return eCmd_Failed;
 		}
 
-		if(strcmp(inArgv[1], "on") == 0)
+		settings.fadeTimeMS = (uint32_t)atol(inArgv[1]);
+
+		SettingsChanged();
+
+		return eCmd_Succeeded;
+	}
+
+	uint8_t
+	GetFadeTime(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
+	{
+		inOutput->printf("%lu\n", (unsigned long)settings.fadeTimeMS);
+
+		return eCmd_Succeeded;
+	}
+
+	uint8_t
+	SetGamma(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
+	{
+		if(inArgC != 2 && inArgC != 5)
 		{
-			gOutdoorLighting->SetOverride(true, true);
-			viewMode = eViewMode_TestPattern;
-			return true;
+			return eCmd_Failed;
 		}
-		else if(strcmp(inArgv[1], "off") == 0)
+
+		settings.gamma = (float)atof(inArgv[1]);
+
+		if(inArgC == 5)
 		{
-			gOutdoorLighting->SetOverride(false, false);
-			viewMode = eViewMode_Normal;
-			return true;
+			settings.colorBalance.r = (float)atof(inArgv[2]);
+			settings.colorBalance.g = (float)atof(inArgv[3]);
+			settings.colorBalance.b = (float)atof(inArgv[4]);
 		}
 
+		SettingsChanged();
+		BuildGammaCurve();
+
 		return eCmd_Succeeded;
 	}
-	
+
 	uint8_t
-	SetColor(
+	GetGamma(
 		IOutputDirector*	inOutput,
 		int					inArgC,
 		char const*			inArgv[])
 	{
-		if(inArgC != 4)
+		inOutput->printf("%f %f %f %f\n", settings.gamma, settings.colorBalance.r, settings.colorBalance.g, settings.colorBalance.b);
+
+		return eCmd_Succeeded;
+	}
+
+	uint8_t
+	SetDither(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
+	{
+		if(inArgC != 2 && inArgC != 3)
 		{
 			return eCmd_Failed;
 		}
 
-		settings.defaultColor.r = (float)atof(inArgv[1]);
-		settings.defaultColor.g = (float)atof(inArgv[2]);
-		settings.defaultColor.b = (float)atof(inArgv[3]);
+		if(strcmp(inArgv[1], "on") == 0)
+		{
+			settings.dither = 1;
+		}
+		else if(strcmp(inArgv[1], "off") == 0)
+		{
+			settings.dither = 0;
+		}
+		else
+		{
+			return eCmd_Failed;
+		}
+
+		if(inArgC == 3)
+		{
+			uint32_t	periodUS = (uint32_t)atol(inArgv[2]);
+
+			if(periodUS != 0 && periodUS < eMinFramePeriodUS)
+			{
+				inOutput->printf("The frame period must be at least %d us\n", eMinFramePeriodUS);
+				return eCmd_Failed;
+			}
+			settings.framePeriodUS = periodUS;
+		}
 
-		EEPROMSave();
+		// Requantize the whole frame so no leds are left showing dithered values, or undithered ones on a static frame
+		InvalidateFrame();
+		SettingsChanged();
 
 		return eCmd_Succeeded;
 	}
-	
+
 	uint8_t
-	GetColor(
+	GetDither(
 		IOutputDirector*	inOutput,
 		int					inArgC,
 		char const*			inArgv[])
 	{
-		inOutput->printf("%f %f %f\n", settings.defaultColor.r, settings.defaultColor.g, settings.defaultColor.b);
+		inOutput->printf("%s %lu\n", settings.dither != 0 ? "on" : "off", (unsigned long)GetFramePeriodUS());
 
 		return eCmd_Succeeded;
 	}
 
 	uint8_t
-	SetIntensity(
+	SetPower(
 		IOutputDirector*	inOutput,
 		int					inArgC,
 		char const*			inArgv[])
 	{
-		if(inArgC != 3)
+		if(inArgC != 2 && inArgC != 3)
 		{
 			return eCmd_Failed;
 		}
 
-		settings.defaultIntensity = (float)atof(inArgv[1]);
-		settings.activeIntensity = (float)atof(inArgv[2]);
+		settings.powerBudgetMA = (uint32_t)atol(inArgv[1]);
+		if(inArgC == 3)
+		{
+			settings.channelMA = (uint32_t)atol(inArgv[2]);
+		}
 
-		EEPROMSave();
+		SettingsChanged();
 
 		return eCmd_Succeeded;
 	}
 
 	uint8_t
-	GetIntensity(
+	GetPower(
 		IOutputDirector*	inOutput,
 		int					inArgC,
 		char const*			inArgv[])
 	{
-		inOutput->printf("%f %f\n", settings.defaultIntensity, settings.activeIntensity);
+		uint16_t	limitScale = viewMode == eViewMode_Stream || viewMode == eViewMode_Sequence ? rawPowerScale : powerLimitScale;
+
+		inOutput->printf("budget=%lu ma estimated=%lu ma limit=%u/256\n", (unsigned long)settings.powerBudgetMA, (unsigned long)GetEstimatedMA(), limitScale);
 
 		return eCmd_Succeeded;
 	}
@@ -815,7 +5063,7 @@ private:
 			luminosityInterface->SetMinMaxLux(settings.minLux, settings.maxLux);
 		}
 
-		EEPROMSave();
+		SettingsChanged();
 
 		return eCmd_Succeeded;
 	}
@@ -831,58 +5079,263 @@ private:
 		return eCmd_Succeeded;
 	}
 
+	uint8_t
+	GetLuxCurve(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
+	{
+		inOutput->printf("curve=");
+		for(int itr = 0; itr < eLuxCurvePoints; ++itr)
+		{
+			inOutput->printf(itr < eLuxCurvePoints - 1 ? "%.3f," : "%.3f", settings.luxCurve[itr]);
+		}
+		inOutput->printf(" deadband=%.3f hysteresis=%.3f steps=%u\n", settings.luxDeadband, settings.luxHysteresis, settings.luxSteps);
+		inOutput->printf("brightness=%.3f intensity=%.3f\n", luxBrightness, luxIntensity);
+
+		return eCmd_Succeeded;
+	}
+
+	uint8_t
+	GetMotionStats(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
+	{
+		inOutput->printf("edges=%lu shown=%lu callbackLastUS=%lu callbackAvgUS=%lu callbackMaxUS=%lu framePeriodUS=%lu\n", (unsigned long)motionStats.edges, (unsigned long)motionStats.responses, (unsigned long)motionStats.lastUS,
+			(unsigned long)(motionStats.responses > 0 ? uint32_t(motionStats.totalUS / motionStats.responses) : 0), (unsigned long)motionStats.maxUS, (unsigned long)GetFramePeriodUS());
+
+		return eCmd_Succeeded;
+	}
+
+	uint8_t
+	ResetMotionStats(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
+	{
+		memset(&motionStats, 0, sizeof(motionStats));
+
+		return eCmd_Succeeded;
+	}
+
+	uint8_t
+	GetFrameStats(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
+	{
+		uint32_t	elapsedMS = uint32_t(gCurLocalMS - frameStats.startMS);
+
+		inOutput->printf("shown=%lu dropped=%lu maxUpdateUS=%lu idleTicks=%lu\n", (unsigned long)frameStats.framesShown, (unsigned long)frameStats.framesDropped, (unsigned long)frameStats.maxUpdateUS, (unsigned long)frameStats.idleTicks);
+		inOutput->printf("firstFrameUS=%lu bootState=%d\n", (unsigned long)bootFrameUS, bootStateShown);
+
+		// The rates are counted from the frames shown, the average since the reset, the last second and the best second
+		inOutput->printf("fps=%lu windowFPS=%lu peakFPS=%lu transferUS=%lu\n", elapsedMS > 0 ? (unsigned long)(uint64_t(frameStats.framesShown) * 1000 / elapsedMS) : 0UL,
+			(unsigned long)frameStats.windowFPS, (unsigned long)frameStats.peakFPS, (unsigned long)eFrameTransferUS);
+
+		return eCmd_Succeeded;
+	}
+
+	uint8_t
+	GetTelemetry(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
+	{
+		inOutput->printf("recorded=%lu pending=%lu lost=%lu batches=%lu\n", (unsigned long)telemetryHead, (unsigned long)(telemetryHead - telemetryTail), (unsigned long)telemetryLost, (unsigned long)telemetryBatches);
+
+		return eCmd_Succeeded;
+	}
+
+	uint8_t
+	FlushTelemetry(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
+	{
+		// The waiting records go out on the following updates
+		telemetryFlushMS = gCurLocalMS - eTelemetryFlushMS;
+
+		return eCmd_Succeeded;
+	}
+
+	uint8_t
+	ResetFrameStats(
+		IOutputDirector*	inOutput,
+		int					inArgC,
+		char const*			inArgv[])
+	{
+		memset(&frameStats, 0, sizeof(frameStats));
+		frameStats.startMS = gCurLocalMS;
+		frameStats.windowStartMS = gCurLocalMS;
+
+		return eCmd_Succeeded;
+	}
+
 	void
 	FindBasePattern(
 		void)
 	{
 		// Find a pattern given the date
-		basePattern = NULL;
-		int	year, month, day, dow, hour, min, sec;
-		gRealTime->GetComponentsFromEpochTime(gRealTime->GetEpochTime(false), year, month, day, dow, hour, min, sec);
+		uint32_t	epoch = gRealTime->GetEpochTime(false);
+		int			year, month, day, dow, hour, min, sec;
 
-		if(month == 12)
+		// Until the clock is set keep the current pattern and look again at the next calendar check
+		if(epoch < uint32_t(eMinValidEpoch))
 		{
-			basePattern = &gXMasPattern;
+			nextPatternChangeEpoch = 0;
+			return;
 		}
-		else
+
+		gRealTime->GetComponentsFromEpochTime(epoch, year, month, day, dow, hour, min, sec);
+
+		if(year != holidayTableYear)
 		{
-			EHoliday	curHoliday = GetHolidayForDate(year, month, day);
+			BuildHolidayTable(year);
+		}
+
+		// Binary search for the last range that starts on or before today
+		int	dayOfYear = GetDayOfYear(year, month, day);
+		int	lo = 0;
+		int	hi = holidayRangeCount - 1;
+
+		while(lo < hi)
+		{
+			int	mid = (lo + hi + 1) / 2;
 
-			if(curHoliday == eHoliday_None)
+			if(holidayRanges[mid].startDay <= dayOfYear)
 			{
-				// If today is not a holiday check if tomorrow is one
-				gRealTime->GetComponentsFromEpochTime(gRealTime->GetEpochTime(false) + 24 * 60 * 60, year, month, day, dow, hour, min, sec);
-				curHoliday = GetHolidayForDate(year, month, day);
+				lo = mid;
 			}
+			else
+			{
+				hi = mid - 1;
+			}
+		}
+
+		basePattern = holidayRanges[lo].pattern;
+
+		// The pattern next changes at midnight at the start of the next range or the next year when the table is rebuilt
+		int	nextStartDay = lo + 1 < holidayRangeCount ? holidayRanges[lo + 1].startDay : GetDayOfYear(year, 12, 31) + 1;
+		nextPatternChangeEpoch = epoch - (hour * 60 * 60 + min * 60 + sec) + (nextStartDay - dayOfYear) * 24 * 60 * 60;
+
+		SystemMsg("Setting pattern to %s", basePattern == NULL ? "None" : basePattern->GetName());
+	}
+
+	CBasePattern*
+	GetPatternForHoliday(
+		EHoliday	inHoliday)
+	{
+		switch(inHoliday)
+		{
+			case eHoliday_ValintinesDay:
+				return &gValintinePattern;
 
-			switch(curHoliday)
+			case eHoliday_SaintPatricksDay:
+				return &gStPattyPattern;
+
+			case eHoliday_Easter:
+				return &gEasterPattern;
+
+			case eHoliday_IndependenceDay:
+				return &gJuly4Pattern;
+
+			case eHoliday_Halloween:
+				return &gHalloweenPattern;
+
+			default:
+				return NULL;
+		}
+	}
+
+	// Build the sorted list of pattern ranges for every day of the given year
+	void
+	BuildHolidayTable(
+		int	inYear)
+	{
+		int		dayOfYear = 0;
+		int		userStartDay[eUserPatternSlots];
+		int		userWrapDays[eUserPatternSlots];	// The days at the start of the year covered by the range that started last year
+		int		prevYearDays = GetDayOfYear(inYear - 1, 12, 31) + 1;
+		int		overflowDay = -1;					// The first day whose pattern did not fit in the table
+
+		for(int itr = 0; itr < eUserPatternSlots; ++itr)
+		{
+			SUserPatternDesc const*	desc = gUserPatterns[itr].GetDesc();
+
+			userStartDay[itr] = -1;
+			userWrapDays[itr] = 0;
+			if(desc != NULL && desc->startMonth != 0)
 			{
-				case eHoliday_ValintinesDay:
-					basePattern = &gValintinePattern;
-					break;
+				// A range that runs past Dec 31 is split, its days in the new year are at the start of the table
+				userStartDay[itr] = GetDayOfYear(inYear, desc->startMonth, desc->startDay);
+				userWrapDays[itr] = GetDayOfYear(inYear - 1, desc->startMonth, desc->startDay) + desc->dayCount - prevYearDays;
+			}
+		}
 
-				case eHoliday_SaintPatricksDay:
-					basePattern = &gStPattyPattern;
-					break;
+		holidayTableYear = inYear;
+		holidayRangeCount = 0;
 
-				case eHoliday_Easter:
-					basePattern = &gEasterPattern;
-					break;
+		for(int month = 1; month <= 12; ++month)
+		{
+			int	daysInMonth = GetDaysInMonth(inYear, month);
 
-				case eHoliday_IndependenceDay:
-					basePattern = &gJuly4Pattern;
-					break;
+			for(int day = 1; day <= daysInMonth; ++day, ++dayOfYear)
+			{
+				CBasePattern*	pattern;
 
-				case eHoliday_Halloween:
-					basePattern = &gHalloweenPattern;
-					break;
+				if(month == 12)
+				{
+					pattern = &gXMasPattern;
+				}
+				else
+				{
+					EHoliday	curHoliday = GetHolidayForDate(inYear, month, day);
 
-				default:
-					basePattern = NULL;
+					if(curHoliday == eHoliday_None)
+					{
+						// If today is not a holiday check if tomorrow is one
+						curHoliday = day < daysInMonth ? GetHolidayForDate(inYear, month, day + 1) : GetHolidayForDate(inYear, month + 1, 1);
+					}
+
+					pattern = GetPatternForHoliday(curHoliday);
+				}
+
+				// User patterns replace the built in pattern for their days
+				for(int itr = 0; itr < eUserPatternSlots; ++itr)
+				{
+					if(userStartDay[itr] >= 0 && ((dayOfYear >= userStartDay[itr] && dayOfYear < userStartDay[itr] + gUserPatterns[itr].GetDesc()->dayCount) || dayOfYear < userWrapDays[itr]))
+					{
+						pattern = &gUserPatterns[itr];
+					}
+				}
+
+				if(holidayRangeCount > 0 && holidayRanges[holidayRangeCount - 1].pattern == pattern)
+				{
+					continue;
+				}
+
+				if(holidayRangeCount >= eMaxHolidayRanges)
+				{
+					// The rest of the year keeps the last pattern that fit
+					if(overflowDay < 0)
+					{
+						overflowDay = dayOfYear;
+					}
+					continue;
+				}
+
+				holidayRanges[holidayRangeCount].startDay = uint16_t(dayOfYear);
+				holidayRanges[holidayRangeCount].pattern = pattern;
+				++holidayRangeCount;
 			}
 		}
 
-		SystemMsg("Setting pattern to %s", basePattern == NULL ? "None" : basePattern->GetName());
+		if(overflowDay >= 0)
+		{
+			SystemMsg("The holiday calendar for %d needs more than %d ranges, the patterns from day %d are not shown", inYear, eMaxHolidayRanges, overflowDay + 1);
+		}
 	}
 
 	OctoWS2811	leds;
@@ -890,8 +5343,98 @@ private:
 	uint8_t		viewMode;
 	bool		toggleState;
 
-	SFloatPixel		frameBuffer[eLEDCount];
+	bool		bootStateShown;		// The state saved in the settings is shown until the lighting control gives the led state
+	bool		bootOverride;		// The lighting override is held on so the transformer powers the leds while the boot state is shown
+	uint64_t	bootTimeValidMS;	// The time the clock was first seen to be valid while the boot state is shown, 0 if it has not been
+	uint32_t	bootFrameUS;		// The time from power on to the first frame being on the leds
+
+	SPixel			frameBuffer[eLEDCount];
+	SRGBPixel	outputFrame[eLEDCount];		// The last value written to each led in left to right order
 	CBasePattern*	basePattern;
+	CBasePattern*	drawnPattern;				// The pattern currently drawn into frameBuffer
+	SLayer			layers[eMaxLayers];
+	SPixelSpan		layerDirty[eMaxLayers];		// The leds each layer changed this frame, the union of where it was and where it is
+	int				activeLayerCount;
+	CBasePattern*	fusedPattern;				// The pattern drawn straight into outputFrame by its fused kernel, NULL if outputFrame came from frameBuffer
+	uint32_t		lastPatternTimeMS;
+	bool			frameBufferValid;
+	uint16_t		outputScale;				// The intensity scale outputFrame was quantized with, after the power limit
+	uint32_t		outputSum;					// The sum of every channel of outputFrame, the current estimate is made from this
+	uint16_t		powerLimitScale;			// The 8.8 fixed point scale applied on top of the intensity to keep the current in budget
+	uint16_t		rawPowerScale;				// The 8.8 fixed point scale BlitFrame applies to stream and sequence frames to keep the current in budget, 256 otherwise
+	uint16_t		outputLUT[3][256];			// Maps frame buffer channel values to 8.8 fixed point output values for outputScale
+	SRGBPixel		ditherError[eLEDCount];		// The fraction of each channel not yet shown when dithering
+	uint32_t		frameTimeUS;				// The time since the last frame was rendered, the next frame steps by this
+	uint32_t		frameDueUS;					// The time counted toward the next frame deadline, the next frame is rendered once it reaches the frame period
+	bool			luxValid;					// True if luxIntensity has been found from the lux curve settings
+	float			luxSample;					// The last brightness read from the lux sensor
+	float			luxBrightness;				// The brightness luxIntensity was found from
+	int8_t			luxDirection;				// The direction the brightness last moved in, 0 if it has not moved
+	float			luxIntensity;				// The lux curve output for luxBrightness
+	bool			idle;						// True while the output is static and updates are skipped until idleWakeMS or an event
+	uint64_t		idleWakeMS;
+	uint16_t		gammaCurve[eGammaCurveSize];
+	float			currentIntensity;			// The intensity in normal mode, this fades towards the target intensity
+	SPixelSpan		outputDirty;				// The range of outputFrame that has changed since the last leds.show()
+	bool			showPending;				// True if the drawing memory holds a frame that has not been sent yet
+
+	SFrameStats		frameStats;
+
+	STelemetryRecord	telemetryRing[eTelemetryRingSize];
+	uint32_t			telemetryHead;				// The count of records ever written, the ring index is this modulo the ring size
+	uint32_t			telemetryTail;				// The count of records sent or lost
+	uint32_t			telemetryLost;				// The records lost to a full ring since the last batch was sent
+	uint32_t			telemetryBatches;
+	uint64_t			telemetryFlushMS;			// The time the ring was last emptied
+	uint64_t			telemetryFramesMS;			// The time of the last frames record and the counters it was made from
+	uint32_t			telemetryFramesShown;
+	uint32_t			telemetryFramesDropped;
+	uint32_t			telemetryMaxUpdateUS;		// The worst update since the last frames record
+	CBasePattern*		telemetryPattern;			// The pattern and view mode of the last pattern record
+	uint8_t				telemetryViewMode;
+
+	SPerfRing		perfRing[ePerfStageCount];
+	uint32_t		perfFrame[ePerfStageCount];	// The cycles spent in each stage during the current frame
+	uint32_t		updateExitCycles;
+
+	// The cached home page and the state it was built from
+	char			statusPageHTML[eStatusPageSize];
+	char			statusPageJSON[eStatusPageSize / 2];
+	int				statusPageHTMLLen;
+	int				statusPageJSONLen;
+	bool			statusPageValid;
+	uint8_t			statusViewMode;
+	CBasePattern*	statusPattern;
+
+	bool		settingsDirty;			// The settings have changed since they were last saved to the eeprom
+	uint64_t	settingsChangedMS;
+
+	SPixelSpan		streamDirty;				// The leds written by stream packets since the last frame ended
+	uint64_t		streamLastPacketMS;
+	SStreamStats	streamStats;
+	bool			streamBaseValid;			// outputFrame holds the frame coded delta packets apply to
+	bool			streamFrameLoss;			// A packet of the current coded frame was lost
+
+	bool			syncActive;					// Following the state of a sync master
+	float			syncIntensity;
+	uint32_t		patternTimeOffsetMS;		// Added to the local time to get the pattern time
+	uint32_t		syncWindowOffsetMS;			// The largest offset seen in the current window
+	uint64_t		syncWindowStartMS;
+	uint64_t		syncLastMS;
+	uint32_t		syncTargetOffsetMS;			// The offset patternTimeOffsetMS is slewed towards
+	uint64_t		syncSlewMS;					// The local time the slew has been applied up to
+
+	bool			sdPresent;
+	CSequencePlayer	sequencePlayer;
+	uint64_t		sequenceStartMS;			// The local time frame 0 of the sequence was due
+	uint32_t		sequenceShownFrame;
+	uint32_t		sequenceLateFrames;			// Frames that were not read from the sd card in time
+
+	SHolidayRange	holidayRanges[eMaxHolidayRanges];
+	int				holidayRangeCount;
+	int				holidayTableYear;			// The year holidayRanges was built for
+	uint32_t		nextPatternChangeEpoch;		// The local time FindBasePattern() needs to be called again
+	uint64_t		calendarCheckMS;
 
 	uint64_t	cyclePatternTimeMS;
 	int			cyclePatternCount;
@@ -904,6 +5447,9 @@ private:
 	int		timeOfDay;
 	bool	ledsOn;
 	bool	motionSensorTriggered;
+	uint32_t	motionCallbackUS;		// The time MotionSensorStateChange() was called for the last rising edge
+	bool		motionResponsePending;	// True until the frame rendered for the last motion edge has been shown
+	SMotionStats	motionStats;
 };
 
 MModuleImplementation_Start(COutdoorLightingModule)
@@ -34,6 +34,7 @@
 #include <FlexCAN.h>
 #include <OctoWS2811.h>
 #include <i2c_t3.h>
+#include <SD.h>
 #include <SPI.h>
 #include <XPT2046_Touchscreen.h>
 
@@ -0,0 +1,268 @@
+/*
+	Author: Brent Pease
+
+	The MIT License (MIT)
+
+	Copyright (c) 2015-FOREVER Brent Pease
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+/*
+	ABOUT
+
+	The host implementations of the interfaces in FHHostMocks.h.
+*/
+
+#include <chrono>
+#include <time.h>
+
+#include "FHHostMocks.h"
+
+HardwareSerial						Serial1;
+uint64_t							gCurLocalMS;
+SDClass								SD;
+
+static CModule_RealTime				gRealTimeModule;
+static CModule_Internet				gInternet;
+static CModule_OutdoorLightingControl	gOutdoorLightingControl;
+
+CModule_RealTime*					gRealTime = &gRealTimeModule;
+CModule_Internet*					gInternetModule = &gInternet;
+CModule_OutdoorLightingControl*		gOutdoorLighting = &gOutdoorLightingControl;
+
+uint32_t
+micros(
+	void)
+{
+	return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint32_t
+millis(
+	void)
+{
+	return uint32_t(gCurLocalMS);
+}
+
+void
+IOutputDirector::printf(
+	char const*	inMsg,
+	...)
+{
+	char	buffer[1024];
+	va_list	varArgs;
+
+	va_start(varArgs, inMsg);
+	int	len = vsnprintf(buffer, sizeof(buffer), inMsg, varArgs);
+	va_end(varArgs);
+
+	if(len > 0)
+	{
+		write(buffer, len < int(sizeof(buffer)) ? len : sizeof(buffer) - 1);
+	}
+}
+
+CModule::CModule(
+	uint16_t	inEEPROMSize,
+	uint8_t		inEEPROMVersion,
+	void*		inEEPROMData,
+	uint32_t	inUpdateTimeUS,
+	uint8_t		inPriority)
+{
+}
+
+void
+CModule::EEPROMSave(
+	void)
+{
+}
+
+// System messages are dropped so the test output only has the test results
+void
+SystemMsg(
+	char const*	inMsg,
+	...)
+{
+}
+
+void
+AddSysMsgHandler(
+	ISysMsgHandler*	inHandler)
+{
+}
+
+void
+RegisterCommand(
+	char const*		inName,
+	ICmdHandler*	inHandler,
+	TCmdMethod		inMethod,
+	char const*		inHelp)
+{
+}
+
+IRealTimeDataProvider*
+CreateDS3234Provider(
+	int	inChipSelect)
+{
+	return NULL;
+}
+
+IRealTimeDataProvider*
+CreateNTPProvider(
+	char const*	inServer,
+	int			inPort)
+{
+	return NULL;
+}
+
+uint32_t
+CModule_RealTime::GetEpochTime(
+	bool	inUTC)
+{
+	return epoch;
+}
+
+void
+CModule_RealTime::GetComponentsFromEpochTime(
+	uint32_t	inEpoch,
+	int&		outYear,
+	int&		outMonth,
+	int&		outDay,
+	int&		outDOW,
+	int&		outHour,
+	int&		outMin,
+	int&		outSec)
+{
+	// This works out the civil date from the day count, see http://howardhinnant.github.io/date_algorithms.html
+	int32_t		days = int32_t(inEpoch / 86400) + 719468;
+	uint32_t	secs = inEpoch % 86400;
+	int32_t		era = days / 146097;
+	uint32_t	dayOfEra = uint32_t(days - era * 146097);
+	uint32_t	yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+	uint32_t	dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+	uint32_t	monthIndex = (5 * dayOfYear + 2) / 153;
+
+	outDay = int(dayOfYear - (153 * monthIndex + 2) / 5 + 1);
+	outMonth = int(monthIndex < 10 ? monthIndex + 3 : monthIndex - 9);
+	outYear = int(yearOfEra) + era * 400 + (outMonth <= 2 ? 1 : 0);
+	outDOW = int((inEpoch / 86400 + 4) % 7);
+	outHour = int(secs / 3600);
+	outMin = int(secs / 60 % 60);
+	outSec = int(secs % 60);
+}
+
+CModule_Loggly*
+CModule_Loggly::Include(
+	char const*	inTag)
+{
+	static CModule_Loggly	gLoggly;
+
+	return &gLoggly;
+}
+
+EHoliday
+GetHolidayForDate(
+	int	inYear,
+	int	inMonth,
+	int	inDay)
+{
+	// Easter Sunday from the anonymous Gregorian algorithm
+	int	a = inYear % 19;
+	int	b = inYear / 100;
+	int	c = inYear % 100;
+	int	h = (19 * a + b - b / 4 - (b - (8 * b + 13) / 25) + 15) % 30;
+	int	l = (32 + 2 * (b % 4) + 2 * (c / 4) - h - c % 4) % 7;
+	int	m = (a + 11 * h + 22 * l) / 451;
+	int	easterMonth = (h + l - 7 * m + 114) / 31;
+	int	easterDay = (h + l - 7 * m + 114) % 31 + 1;
+
+	if(inMonth == 1 && inDay == 1)
+	{
+		return eHoliday_NewYearsDay;
+	}
+	if(inMonth == 2 && inDay == 14)
+	{
+		return eHoliday_ValintinesDay;
+	}
+	if(inMonth == 3 && inDay == 17)
+	{
+		return eHoliday_SaintPatricksDay;
+	}
+	if(inMonth == easterMonth && inDay == easterDay)
+	{
+		return eHoliday_Easter;
+	}
+	if(inMonth == 7 && inDay == 4)
+	{
+		return eHoliday_IndependenceDay;
+	}
+	if(inMonth == 10 && inDay == 31)
+	{
+		return eHoliday_Halloween;
+	}
+	if(inMonth == 12 && inDay == 25)
+	{
+		return eHoliday_Christmas;
+	}
+
+	return eHoliday_None;
+}
+
+OctoWS2811::OctoWS2811(
+	uint32_t	inLEDsPerStrip,
+	void*		inDisplayMemory,
+	void*		inDrawingMemory,
+	uint8_t		inConfig)
+	:
+	ledsPerStrip(inLEDsPerStrip),
+	displayMemory((uint8_t*)inDisplayMemory),
+	drawingMemory((uint8_t*)inDrawingMemory),
+	showCount(0)
+{
+}
+
+void
+OctoWS2811::begin(
+	void)
+{
+	memset(displayMemory, 0, ledsPerStrip * 24);
+	memset(drawingMemory, 0, ledsPerStrip * 24);
+}
+
+void
+OctoWS2811::show(
+	void)
+{
+	memcpy(displayMemory, drawingMemory, ledsPerStrip * 24);
+	++showCount;
+}
+
+uint32_t
+File::size(
+	void)
+{
+	long	pos = ftell(file);
+
+	fseek(file, 0, SEEK_END);
+	long	result = ftell(file);
+	fseek(file, pos, SEEK_SET);
+
+	return (uint32_t)result;
+}
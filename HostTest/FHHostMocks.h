@@ -0,0 +1,422 @@
+/*
+	Author: Brent Pease
+
+	The MIT License (MIT)
+
+	Copyright (c) 2015-FOREVER Brent Pease
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+/*
+	ABOUT
+
+	Host versions of the Arduino, Teensy and EmbeddedLibrary interfaces FHOutdoorLighting.cpp uses so it can be built and run on a pc.
+	Only the parts of each interface the module calls are here. The headers in Mocks have the library names and include this one.
+
+	The led output keeps the OctoWS2811 bit plane layout so the drawing memory can be compared between builds.
+	Time only moves when the test sets gCurLocalMS, micros() is the real time so renders can be timed.
+*/
+
+#ifndef _FHHOSTMOCKS_H_
+#define _FHHOSTMOCKS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <math.h>
+
+#define DMAMEM
+#define F_CPU 72000000
+#define WS2811_RGB 0
+#define FILE_READ 0
+
+// Lets gcc and clang check the formats the module passes to printf style calls, the embedded build has no such checks
+#if defined(__GNUC__)
+#define MPrintfFormat(inFormatArg, inFirstArg) __attribute__((format(printf, inFormatArg, inFirstArg)))
+#else
+#define MPrintfFormat(inFormatArg, inFirstArg)
+#endif
+
+uint32_t
+micros(
+	void);
+
+uint32_t
+millis(
+	void);
+
+struct HardwareSerial
+{
+	void begin(int inBaud) {}
+};
+
+extern HardwareSerial	Serial1;
+
+// ELOutput.h
+
+class IOutputDirector
+{
+public:
+
+	virtual void
+	write(
+		char const*	inMsg,
+		size_t		inBytes) = 0;
+
+	void
+	printf(
+		char const*	inMsg,
+		...) MPrintfFormat(2, 3);
+};
+
+// ELModule.h
+
+class ISysMsgHandler
+{
+public:
+
+	virtual void
+	SysMsgHandler(
+		char const*	inMsg)
+	{
+	}
+};
+
+class CModule
+{
+public:
+
+	virtual void
+	Setup(
+		void)
+	{
+	}
+
+	virtual void
+	Update(
+		uint32_t	inDeltaTimeUS)
+	{
+	}
+
+protected:
+
+	CModule(
+		uint16_t	inEEPROMSize = 0,
+		uint8_t		inEEPROMVersion = 0,
+		void*		inEEPROMData = NULL,
+		uint32_t	inUpdateTimeUS = 0,
+		uint8_t		inPriority = 1);
+
+	void
+	EEPROMSave(
+		void);
+};
+
+extern uint64_t	gCurLocalMS;
+
+void
+SystemMsg(
+	char const*	inMsg,
+	...) MPrintfFormat(1, 2);
+
+void
+AddSysMsgHandler(
+	ISysMsgHandler*	inHandler);
+
+#define MModule_Declaration(inClass) static inClass* Include(void);
+#define MModuleImplementation_Start(inClass) inClass* inClass::Include(void) { static inClass* gModule = new inClass; return gModule; }
+#define MModuleImplementation_Finish(inClass)
+
+// ELCommand.h
+
+enum
+{
+	eCmd_Succeeded,
+	eCmd_Failed,
+};
+
+class ICmdHandler
+{
+};
+
+typedef uint8_t (ICmdHandler::*TCmdMethod)(IOutputDirector* inOutput, int inArgC, char const* inArgv[]);
+
+void
+RegisterCommand(
+	char const*		inName,
+	ICmdHandler*	inHandler,
+	TCmdMethod		inMethod,
+	char const*		inHelp);
+
+#define MCommandRegister(inName, inMethod, inHelp) RegisterCommand(inName, this, static_cast<TCmdMethod>(&inMethod), inHelp)
+
+struct CModule_Command
+{
+	static void Include(void) {}
+};
+
+// ELDigitalIO.h, ELSunRiseAndSet.h
+
+class IDigitalIOEventHandler
+{
+};
+
+class ISunRiseAndSetEventHandler
+{
+};
+
+// ELRealTime.h, the clock is a fixed epoch the test sets
+
+class IRealTimeHandler
+{
+};
+
+class IRealTimeDataProvider
+{
+};
+
+IRealTimeDataProvider*
+CreateDS3234Provider(
+	int	inChipSelect);
+
+IRealTimeDataProvider*
+CreateNTPProvider(
+	char const*	inServer,
+	int			inPort);
+
+class CModule_RealTime
+{
+public:
+
+	static void Include(void) {}
+
+	uint32_t
+	GetEpochTime(
+		bool	inUTC);
+
+	void
+	GetComponentsFromEpochTime(
+		uint32_t	inEpoch,
+		int&		outYear,
+		int&		outMonth,
+		int&		outDay,
+		int&		outDOW,
+		int&		outHour,
+		int&		outMin,
+		int&		outSec);
+
+	void
+	Configure(
+		IRealTimeDataProvider*	inProvider1,
+		IRealTimeDataProvider*	inProvider2,
+		int						inSyncPeriodSecs)
+	{
+	}
+
+	uint32_t	epoch;
+};
+
+extern CModule_RealTime*	gRealTime;
+
+// ELInternet.h, ELInternetDevice_ESP8266.h, ELRemoteLogging.h
+
+class IInternetHandler
+{
+};
+
+class IInternetDevice
+{
+};
+
+typedef void (IInternetHandler::*TInternetServerPageMethod)(IOutputDirector* inOutput, int inParamCount, char const** inParamList);
+
+class CModule_Internet
+{
+public:
+
+	static void Include(void) {}
+	void Configure(IInternetDevice* inDevice) {}
+	void WebServer_Start(int inPort) {}
+	void RegisterPage(char const* inPath, IInternetHandler* inHandler, TInternetServerPageMethod inMethod) {}
+};
+
+extern CModule_Internet*	gInternetModule;
+
+#define MInternetRegisterPage(inPath, inMethod) gInternetModule->RegisterPage(inPath, this, static_cast<TInternetServerPageMethod>(&inMethod))
+
+struct CModule_ESP8266
+{
+	static IInternetDevice* Include(HardwareSerial* inSerial, int inResetPin) { return NULL; }
+};
+
+class CModule_Loggly : public ISysMsgHandler
+{
+public:
+
+	static CModule_Loggly* Include(char const* inTag);
+};
+
+// ELLuminositySensor.h, the sensor is never present, a test that needs lux gives the module its own ILuminosity
+
+enum
+{
+	eGain_1X,
+	eIntegrationTime_13_7ms,
+};
+
+class ILuminosity
+{
+public:
+
+	virtual bool IsPresent(void) = 0;
+	virtual void SetMinMaxLux(float inMin, float inMax) = 0;
+};
+
+class CTSL2561Sensor : public ILuminosity
+{
+public:
+
+	CTSL2561Sensor(int inAddress, int inGain, int inIntegrationTime) {}
+	bool IsPresent(void) { return false; }
+	void SetMinMaxLux(float inMin, float inMax) {}
+};
+
+// ELCalendarEvent.h
+
+enum EHoliday
+{
+	eHoliday_None,
+	eHoliday_NewYearsDay,
+	eHoliday_ValintinesDay,
+	eHoliday_SaintPatricksDay,
+	eHoliday_Easter,
+	eHoliday_IndependenceDay,
+	eHoliday_Halloween,
+	eHoliday_Christmas,
+};
+
+EHoliday
+GetHolidayForDate(
+	int	inYear,
+	int	inMonth,
+	int	inDay);
+
+// ELOutdoorLightingControl.h
+
+enum
+{
+	eTimeOfDay_Day,
+	eTimeOfDay_Night,
+};
+
+class IOutdoorLightingInterface
+{
+public:
+
+	virtual void LEDStateChange(bool inLEDsOn) = 0;
+	virtual void MotionSensorStateChange(bool inMotionSensorTriggered) = 0;
+	virtual void LuxSensorStateChange(bool inTriggered) = 0;
+	virtual void PushButtonStateChange(int inToggleCount) = 0;
+	virtual void TimeOfDayChange(int inTimeOfDay) = 0;
+};
+
+class CModule_OutdoorLightingControl
+{
+public:
+
+	static void Include(IOutdoorLightingInterface* inInterface, bool inRelay, int inMotionPin, int inRelayPin, int inButtonPin, ILuminosity* inLuminosity) {}
+	void SetOverride(bool inOverride, bool inLEDsOn) {}
+	float GetAvgBrightness(void) { return avgBrightness; }
+
+	float	avgBrightness;	// The lux sensor brightness from 0 to 1 the library would report, set by the test
+};
+
+extern CModule_OutdoorLightingControl*	gOutdoorLighting;
+
+// OctoWS2811.h, the frames are kept in the drawing memory and never sent
+
+class OctoWS2811
+{
+public:
+
+	OctoWS2811(
+		uint32_t	inLEDsPerStrip,
+		void*		inDisplayMemory,
+		void*		inDrawingMemory,
+		uint8_t		inConfig = WS2811_RGB);
+
+	void
+	begin(
+		void);
+
+	void
+	show(
+		void);
+
+	int
+	busy(
+		void)
+	{
+		return 0;
+	}
+
+	uint32_t	ledsPerStrip;
+	uint8_t*	displayMemory;
+	uint8_t*	drawingMemory;
+	uint32_t	showCount;
+};
+
+// SD.h, files are read from the directory the test runs in
+
+class File
+{
+public:
+
+	File(
+		FILE*	inFile = NULL)
+		:
+		file(inFile)
+	{
+	}
+
+	operator bool() const { return file != NULL; }
+	int read(void* outBuffer, uint16_t inBytes) { return (int)fread(outBuffer, 1, inBytes, file); }
+	bool seek(uint32_t inPos) { return fseek(file, inPos, SEEK_SET) == 0; }
+	uint32_t position(void) { return (uint32_t)ftell(file); }
+	uint32_t size(void);
+	void close(void) { if(file != NULL) fclose(file); file = NULL; }
+
+	FILE*	file;
+};
+
+class SDClass
+{
+public:
+
+	bool begin(uint8_t inChipSelect) { return true; }
+	File open(char const* inName, uint8_t inMode = FILE_READ) { return File(fopen(inName, "rb")); }
+};
+
+extern SDClass	SD;
+
+#endif /* _FHHOSTMOCKS_H_ */
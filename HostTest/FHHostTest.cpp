@@ -0,0 +1,1012 @@
+/*
+	Author: Brent Pease
+
+	The MIT License (MIT)
+
+	Copyright (c) 2015-FOREVER Brent Pease
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+/*
+	ABOUT
+
+	A host build of FHOutdoorLighting.cpp against the mocks in FHHostMocks.h for checking and timing the frame rendering on a pc.
+
+	FHHostTest check			Render fixed frames of every pattern, the test pattern, the day, night, dusk and motion intensities of normal mode,
+								dithering, a fade, each layer effect, the power limit, the motion wave and a codec stream and compare the leds,
+								decoded from the drawing memory which holds the output in strip order, to the frames in FHRenderGoldens.h
+								then run a sync follower against a drifting master whose state arrives with up to eHostTestSyncJitterMS of jitter
+								and round trip FHFrameCodec packets, check bad packets are rejected and measure the compression of solid panel blocks
+	FHHostTest update			Print a new FHRenderGoldens.h from the frames the current code renders
+	FHHostTest bench [frames]	Time a full redraw and a steady frame of every pattern in normal and cycle mode and the test pattern
+
+	The golden frames are stored as text runs of leds from left to right so a failure can name the first led that differs and a diff of
+	FHRenderGoldens.h shows which leds a change moved. Any strip position off cLEDLayout that is lit also fails the case.
+	The cases are keyed by pattern name so adding or reordering patterns does not move the goldens of the others.
+	The float and the 8 bit pixel builds round differently so each has its own goldens, update keeps the goldens of the other build.
+*/
+
+#include "FHHostMocks.h"
+
+#include "../FHOutdoorLighting.cpp"
+
+enum
+{
+	eHostTestEpoch = 1481500800,	// 2016-12-12, a valid clock so the holiday calendar is used
+	eHostTestBenchFrames = 100,
+	eHostTestPatternTimeMS = 100000,	// The pattern time the checked frames are drawn at
+	eHostTestSteps = 4,				// The number of test pattern frames checked
+	eHostTestStepUS = 250000,		// The time between the checked test pattern frames
+	eHostTestMaxGoldens = 64,
+	eHostTestMaxFrames = 4,			// The most frames one case checks
+	eHostTestRunsPerLine = 10,		// The runs of leds on each line of a golden frame in FHRenderGoldens.h
+	eHostTestFadeTimeMS = 200,		// The fade case reaches the active intensity on its last frame
+	eHostTestLayerElapsedMS = 300,	// How far into its period each layer effect is checked
+	eHostTestLayerPeriodMS = 1000,
+	eHostTestPowerBudgetMA = 3000,	// Well under the day frame of the first pattern so the limit engages
+	eHostTestWaveEntryLED = 100,	// Off center so the wave reaches one end before the other
+	eHostTestWaveTimeMS = 1000,
+	eHostTestWaveStepMS = 250,		// The time between the frames of the motion wave case
+	eHostTestSyncRunMS = 180000,	// The time a follower is run against a simulated master
+	eHostTestSyncSettleMS = 2 * eSyncOffsetWindowMS,	// The follower is only checked once its offset has been measured over a full window
+	eHostTestSyncSendMS = 1000,		// How often the master state reaches the follower
+	eHostTestSyncJitterMS = 40,		// The most the master state is delayed on its way to the follower
+	eHostTestSyncDriftPPM = 100,	// How much faster or slower than the follower the master clock runs
+	eHostTestSyncMaxErrorMS = 8,	// The most the follower pattern time may differ from the master's once settled
+	eHostTestCodecFrames = 60,		// The frames of solid panel blocks the compression is measured over
+	eHostTestCodecKeyFrameEvery = 30,	// How often the sender of those frames sends a keyframe
+	eHostTestCodecMinRatio = 20,	// The compression the solid panel block frames must reach
+};
+
+struct SRenderGolden
+{
+	char const*	name;			// The pattern name
+	char const*	mode;			// How the pattern was rendered
+	int			floatPixels;	// The MUseFloatPixels of the build the golden is for
+	char const*	frames[eHostTestMaxFrames];	// The leds of each frame from left to right as runs of countxrrggbb, a single led is just rrggbb
+};
+
+// A normal mode intensity checked, the lux sensor is present so the night cases run the lux curve
+struct SIntensityCase
+{
+	char const*	mode;
+	int			timeOfDay;
+	bool		motion;
+	float		brightness;		// The average brightness the lux sensor reports
+};
+
+#include "FHRenderGoldens.h"
+
+static_assert(sizeof(cRenderGoldens) / sizeof(cRenderGoldens[0]) <= eHostTestMaxGoldens, "Increase eHostTestMaxGoldens");
+
+// A lux sensor that is always present, the brightness it gives comes from gOutdoorLighting->avgBrightness
+class CHostLuminosity : public ILuminosity
+{
+public:
+
+	bool IsPresent(void) { return true; }
+	void SetMinMaxLux(float inMin, float inMax) {}
+};
+
+class CHostTest : public IOutputDirector
+{
+public:
+
+	CHostTest(
+		)
+	{
+		gRealTime->epoch = eHostTestEpoch;
+		gCurLocalMS = 1000;
+
+		module = COutdoorLightingModule::Include();
+
+		// The settings are fixed here so the frames only change when the rendering does, not when the constructor defaults do
+		SSettings&	settings = module->settings;
+
+		settings.defaultColor.r = 1.0f;
+		settings.defaultColor.g = 0.5f;
+		settings.defaultColor.b = 0.25f;
+		settings.defaultIntensity = 0.25f;
+		settings.activeIntensity = 0.75f;
+		settings.minLux = 0.0f;
+		settings.maxLux = 1000.0f;
+		settings.fadeTimeMS = 0;
+		settings.framePeriodUS = 0;
+		settings.dither = 0;
+		settings.powerBudgetMA = 0;
+		settings.channelMA = 0;
+		settings.waveEntryLED = 0;
+		settings.waveTimeMS = 0;
+		settings.gamma = 1.0f;
+		settings.colorBalance.r = 1.0f;
+		settings.colorBalance.g = 1.0f;
+		settings.colorBalance.b = 1.0f;
+		for(int itr = 0; itr < eLuxCurvePoints; ++itr)
+		{
+			settings.luxCurve[itr] = 1.0f - float(itr) / float(eLuxCurvePoints - 1);
+		}
+		settings.luxDeadband = 0.02f;
+		settings.luxHysteresis = 0.02f;
+		settings.luxSteps = 32;
+		memset(&settings.boot, 0, sizeof(settings.boot));
+		settings.boot.patternIndex = 0xFF;
+
+		module->Setup();
+		module->LEDStateChange(true);
+
+		update = false;
+		cases = 0;
+		failed = 0;
+		frameCount = 0;
+		strayCount = 0;
+	}
+
+	void
+	write(
+		char const*	inMsg,
+		size_t		inBytes)
+	{
+		fwrite(inMsg, 1, inBytes, stdout);
+	}
+
+	// Render every case, in update mode print the new goldens otherwise compare to cRenderGoldens and return the number of failures
+	int
+	Check(
+		bool	inUpdate)
+	{
+		SRenderState	savedState;
+		uint32_t		renderUS;
+
+		update = inUpdate;
+		failed = 0;
+		memset(goldenUsed, 0, sizeof(goldenUsed));
+
+		if(update)
+		{
+			printf("// Generated by FHHostTest update from the frames FHOutdoorLighting.cpp renders, the cases are described in FHHostTest.cpp\n\n");
+			printf("SRenderGolden const	cRenderGoldens[] =\n{\n");
+			if(MUseFloatPixels)
+			{
+				PrintOtherGoldens();
+			}
+		}
+
+		module->SaveRenderState(savedState);
+
+		for(int patternItr = 0; patternItr < gPatternCount; ++patternItr)
+		{
+			module->basePattern = gPatternList[patternItr];
+			if(module->basePattern->IsEnabled() == false)
+			{
+				continue;
+			}
+
+			renderUS = 0;
+			module->viewMode = eViewMode_CyclePatterns;
+			RenderPattern(2, renderUS);
+			Case(module->basePattern->GetName(), "cycle", renderUS);
+		}
+
+		module->viewMode = eViewMode_TestPattern;
+		module->testPatternValue = 0;
+		module->InvalidateFrame();
+		for(int stepItr = 0; stepItr < eHostTestSteps; ++stepItr)
+		{
+			char	mode[16];
+
+			renderUS = 0;
+			snprintf(mode, sizeof(mode), "step%d", stepItr);
+			Render(eHostTestStepUS, renderUS);
+			Case("Test", mode, renderUS);
+		}
+
+		// The normal mode cases are checked on the first pattern, SaveRenderState() took the lux sensor away so the host one stands in for it
+		static SIntensityCase const	cIntensityCases[] =
+		{
+			{"day", eTimeOfDay_Day, false, 0.25f},
+			{"night", eTimeOfDay_Night, false, 0.25f},
+			{"dusk", eTimeOfDay_Night, false, 0.6f},
+			{"motion", eTimeOfDay_Night, true, 0.25f},
+		};
+
+		module->basePattern = gPatternList[0];
+		module->viewMode = eViewMode_Normal;
+		module->luminosityInterface = &luxSensor;
+		for(int caseItr = 0; caseItr < int(sizeof(cIntensityCases) / sizeof(cIntensityCases[0])); ++caseItr)
+		{
+			renderUS = 0;
+			module->timeOfDay = cIntensityCases[caseItr].timeOfDay;
+			module->motionSensorTriggered = cIntensityCases[caseItr].motion;
+			SetBrightness(cIntensityCases[caseItr].brightness);
+			RenderPattern(2, renderUS);
+			Case(module->basePattern->GetName(), cIntensityCases[caseItr].mode, renderUS);
+		}
+
+		// The rest are at night in the dark so the intensity is the default one
+		module->timeOfDay = eTimeOfDay_Night;
+		module->motionSensorTriggered = false;
+		SetBrightness(0.0f);
+
+		// The default intensity falls between output levels so the dithered frames alternate
+		renderUS = 0;
+		module->settings.dither = 1;
+		memset(module->ditherError, 0, sizeof(module->ditherError));
+		RenderPattern(4, renderUS);
+		Case(module->basePattern->GetName(), "dither", renderUS);
+		module->settings.dither = 0;
+
+		// Motion starts a fade from the default to the active intensity
+		renderUS = 0;
+		module->settings.fadeTimeMS = eHostTestFadeTimeMS;
+		module->currentIntensity = module->settings.defaultIntensity;
+		module->motionSensorTriggered = true;
+		RenderPattern(4, renderUS);
+		Case(module->basePattern->GetName(), "fade", renderUS);
+		module->settings.fadeTimeMS = 0;
+		module->motionSensorTriggered = false;
+
+		// Each effect is layered over part of the roof in the day so the layer colors are not scaled down
+		SPixel	white, blue, gray;
+
+		SetPixelRGB(white, 255, 255, 255);
+		SetPixelRGB(blue, 0, 0, 255);
+		SetPixelRGB(gray, 128, 128, 128);
+		module->timeOfDay = eTimeOfDay_Day;
+		RenderLayer(&gSweepEffect, eBlend_Over, white, 20);
+		RenderLayer(&gSparkleEffect, eBlend_Add, blue, 128);
+		RenderLayer(&gFlashEffect, eBlend_Max, gray, 0);
+
+		// The full day frame draws more than the budget so the frames after the first are limited
+		renderUS = 0;
+		module->settings.powerBudgetMA = eHostTestPowerBudgetMA;
+		RenderPattern(3, renderUS);
+		Case(module->basePattern->GetName(), "power", renderUS);
+		module->settings.powerBudgetMA = 0;
+		module->powerLimitScale = 256;
+		module->timeOfDay = eTimeOfDay_Night;
+
+		// The frame before motion then the frame the motion callback shows and two as the wave spreads from the entry led
+		renderUS = 0;
+		module->settings.waveEntryLED = eHostTestWaveEntryLED;
+		module->settings.waveTimeMS = eHostTestWaveTimeMS;
+		RenderPattern(1, renderUS);
+		module->MotionSensorStateChange(true);
+		ReadFrame();
+		for(int frameItr = 0; frameItr < 2; ++frameItr)
+		{
+			gCurLocalMS += eHostTestWaveStepMS;
+			Render(eHostTestWaveStepMS * 1000, renderUS);
+		}
+		Case(module->basePattern->GetName(), "wave", renderUS);
+		module->settings.waveEntryLED = 0;
+		module->settings.waveTimeMS = 0;
+		module->MotionSensorStateChange(false);
+		ClearLayers();
+
+		RenderStream();
+
+		module->luxValid = false;
+		module->RestoreRenderState(savedState);
+
+		if(update)
+		{
+			if(!MUseFloatPixels)
+			{
+				PrintOtherGoldens();
+			}
+			printf("};\n");
+			return 0;
+		}
+
+		// A golden that no case rendered belongs to a pattern that was renamed or removed
+		for(int itr = 0; itr < int(sizeof(cRenderGoldens) / sizeof(cRenderGoldens[0])); ++itr)
+		{
+			if(cRenderGoldens[itr].floatPixels == MUseFloatPixels && goldenUsed[itr] == false)
+			{
+				printf("%s %s not rendered\n", cRenderGoldens[itr].name, cRenderGoldens[itr].mode);
+				++failed;
+			}
+		}
+
+		printf("cases=%d failed=%d\n", cases, failed);
+
+		return failed;
+	}
+
+	// Run a follower against a master clock that drifts, with the state delayed by a random jitter, and check the follower pattern time tracks the master's and never steps back
+	int
+	CheckSync(
+		void)
+	{
+		static int const	cDriftPPM[] = {-eHostTestSyncDriftPPM, 0, eHostTestSyncDriftPPM};
+		int					syncFailed = 0;
+		uint32_t			random = 1;
+
+		module->viewMode = eViewMode_Normal;
+		for(int driftItr = 0; driftItr < int(sizeof(cDriftPPM) / sizeof(cDriftPPM[0])); ++driftItr)
+		{
+			uint64_t	startMS = gCurLocalMS;
+			uint64_t	sendMS = startMS;
+			uint64_t	deliverMS = 0;
+			uint32_t	sentPatternMS = 0;
+			uint32_t	prevPatternMS = 0;
+			int32_t		minErrorMS = 0;
+			int32_t		maxErrorMS = 0;
+			bool		stepBack = false;
+
+			for(uint64_t timeMS = 0; timeMS < eHostTestSyncRunMS; timeMS += eUpdateTickUS / 1000)
+			{
+				gCurLocalMS = startMS + timeMS;
+
+				// The master started its patterns well before the follower and its clock runs at its own rate
+				uint32_t	masterMS = uint32_t(1000000 + timeMS + int64_t(timeMS) * cDriftPPM[driftItr] / 1000000);
+
+				if(gCurLocalMS >= sendMS)
+				{
+					random = random * 1103515245 + 12345;
+					sentPatternMS = masterMS;
+					deliverMS = sendMS + (random >> 16) % (eHostTestSyncJitterMS + 1);
+					sendMS += eHostTestSyncSendMS;
+				}
+				if(deliverMS != 0 && gCurLocalMS >= deliverMS)
+				{
+					module->SyncStateReceived(0, sentPatternMS, 0.5f);
+					deliverMS = 0;
+				}
+
+				module->Update(eUpdateTickUS);
+
+				uint32_t	patternMS = module->GetPatternTimeMS();
+
+				if(timeMS != 0 && int32_t(patternMS - prevPatternMS) < 0)
+				{
+					stepBack = true;
+				}
+				prevPatternMS = patternMS;
+
+				if(timeMS >= eHostTestSyncSettleMS)
+				{
+					int32_t	errorMS = int32_t(patternMS - masterMS);
+
+					minErrorMS = errorMS < minErrorMS ? errorMS : minErrorMS;
+					maxErrorMS = errorMS > maxErrorMS ? errorMS : maxErrorMS;
+				}
+			}
+
+			bool	ok = stepBack == false && -minErrorMS <= eHostTestSyncMaxErrorMS && maxErrorMS <= eHostTestSyncMaxErrorMS;
+
+			++cases;
+			printf("Sync drift%+dppm error=%d..%dms stepback=%d %s\n", cDriftPPM[driftItr], minErrorMS, maxErrorMS, stepBack, ok ? "ok" : "FAIL");
+			if(ok == false)
+			{
+				++syncFailed;
+			}
+
+			module->StopSync();
+		}
+
+		return syncFailed;
+	}
+
+	// Round trip keyframes and deltas through FHFrameCodec, check bad packets are rejected without writing any led and measure the compression of solid panel blocks
+	int
+	CheckCodec(
+		void)
+	{
+		static uint8_t	source[eLEDCount * 3];
+		static uint8_t	prev[eLEDCount * 3];
+		static uint8_t	decoded[eLEDCount * 3];
+		static uint8_t	before[eLEDCount * 3];
+		int				codecFailed = 0;
+		uint32_t		random = 1;
+
+		// A keyframe of noise with runs mixed in decodes over any previous content
+		for(int itr = 0; itr < eLEDCount * 3; ++itr)
+		{
+			random = random * 1103515245 + 12345;
+			source[itr] = (itr / 3) % 7 < 3 ? uint8_t(itr % 3) : uint8_t(random >> 16);
+		}
+		memset(decoded, 0xAA, sizeof(decoded));
+		codecFailed += CodecCase("keyframe", RoundTrip(source, NULL, decoded) > 0 && memcmp(source, decoded, sizeof(source)) == 0);
+
+		// A delta only sends the leds that changed and applies to the previous frame
+		memcpy(prev, source, sizeof(prev));
+		for(int itr = 0; itr < eLEDCount; itr += 5)
+		{
+			source[itr * 3] ^= 0xFF;
+		}
+		codecFailed += CodecCase("delta", RoundTrip(source, prev, decoded) > 0 && memcmp(source, decoded, sizeof(source)) == 0);
+
+		// Bad packets are rejected and leave every led as it was, each has a valid run first that the decoder could have written before finding the error
+		uint8_t	truncated[] = {eFrameCodecFlag_KeyFrame, 0, 0, eFrameOp_Run | 3, 9, 9, 9, eFrameOp_Literal | 1, 1, 2, 3, 4, 5};
+		uint8_t	badOp[] = {eFrameCodecFlag_KeyFrame, 0, 0, eFrameOp_Run | 3, 9, 9, 9, eFrameOp_TypeMask};
+		uint8_t	keySkip[] = {eFrameCodecFlag_KeyFrame, 0, 0, eFrameOp_Run | 3, 9, 9, 9, eFrameOp_Skip | 3};
+		uint8_t	range[] = {0, uint8_t((eLEDCount - 8) & 0xFF), uint8_t((eLEDCount - 8) >> 8), eFrameOp_Run | 3, 9, 9, 9, eFrameOp_Run | 7, 9, 9, 9};
+		int		dirtyStart, dirtyEnd;
+
+		memcpy(before, prev, sizeof(before));
+		memcpy(decoded, prev, sizeof(decoded));
+		codecFailed += CodecCase("truncated", FrameCodecDecode(truncated, sizeof(truncated), decoded, eLEDCount, dirtyStart, dirtyEnd) == false
+			&& memcmp(decoded, before, sizeof(before)) == 0);
+		codecFailed += CodecCase("header", FrameCodecDecode(truncated, eFrameCodecHeaderSize - 1, decoded, eLEDCount, dirtyStart, dirtyEnd) == false);
+		codecFailed += CodecCase("badop", FrameCodecDecode(badOp, sizeof(badOp), decoded, eLEDCount, dirtyStart, dirtyEnd) == false
+			&& memcmp(decoded, before, sizeof(before)) == 0);
+		codecFailed += CodecCase("keyskip", FrameCodecDecode(keySkip, sizeof(keySkip), decoded, eLEDCount, dirtyStart, dirtyEnd) == false
+			&& memcmp(decoded, before, sizeof(before)) == 0);
+		codecFailed += CodecCase("range", FrameCodecDecode(range, sizeof(range), decoded, eLEDCount, dirtyStart, dirtyEnd) == false
+			&& memcmp(decoded, before, sizeof(before)) == 0);
+
+		// Solid panel blocks that change a couple of panels a frame, with a periodic keyframe the way a sender recovers from loss
+		uint32_t	bytes = 0;
+
+		for(int frameItr = 0; frameItr < eHostTestCodecFrames; ++frameItr)
+		{
+			memcpy(prev, source, sizeof(prev));
+			for(int ledItr = 0; ledItr < eLEDCount; ++ledItr)
+			{
+				int	panel = ledItr / eLEDsPerPanel;
+
+				if(frameItr == 0 || panel == frameItr % ePanelCount || panel == (frameItr * 3) % ePanelCount)
+				{
+					source[ledItr * 3] = uint8_t(frameItr * 40 + panel * 25);
+					source[ledItr * 3 + 1] = uint8_t(frameItr * 15);
+					source[ledItr * 3 + 2] = uint8_t(panel * 60);
+				}
+			}
+
+			int	frameBytes = RoundTrip(source, frameItr % eHostTestCodecKeyFrameEvery == 0 ? NULL : prev, decoded);
+
+			if(frameBytes == 0 || memcmp(source, decoded, sizeof(source)) != 0)
+			{
+				bytes = 0;
+				break;
+			}
+			bytes += frameBytes;
+		}
+
+		float	ratio = bytes > 0 ? float(eHostTestCodecFrames) * eLEDCount * 3 / float(bytes) : 0.0f;
+
+		printf("Codec panels compression=%.1fx\n", ratio);
+		codecFailed += CodecCase("compression", ratio >= eHostTestCodecMinRatio);
+
+		return codecFailed;
+	}
+
+	int
+	Bench(
+		int	inFrames)
+	{
+		char		frames[16];
+		char const*	argv[] = {"bench", frames};
+
+		snprintf(frames, sizeof(frames), "%d", inFrames);
+
+		return module->Benchmark(this, 2, argv) == eCmd_Succeeded ? 0 : 1;
+	}
+
+	COutdoorLightingModule*	module;
+
+private:
+
+	// Set the brightness the lux sensor reports and have the curve evaluated for it on the next frame
+	void
+	SetBrightness(
+		float	inBrightness)
+	{
+		gOutdoorLighting->avgBrightness = inBrightness;
+		module->luxValid = false;
+	}
+
+	// Render a frame and read it back from the drawing memory, the time spent rendering is added to ioRenderUS
+	void
+	Render(
+		uint32_t	inDeltaTimeUS,
+		uint32_t&	ioRenderUS)
+	{
+		uint32_t	startUS = micros();
+
+		module->RenderFrame(inDeltaTimeUS);
+		if(module->outputDirty.IsEmpty() == false)
+		{
+			module->BlitFrame(module->outputDirty.start, module->outputDirty.end);
+			module->outputDirty.Clear();
+		}
+		ioRenderUS += micros() - startUS;
+
+		ReadFrame();
+	}
+
+	// Render a full redraw at the fixed pattern time then inFrames - 1 updates a frame period apart
+	void
+	RenderPattern(
+		int			inFrames,
+		uint32_t&	ioRenderUS)
+	{
+		uint32_t	periodUS = module->GetFramePeriodUS();
+
+		module->patternTimeOffsetMS = uint32_t(eHostTestPatternTimeMS) - uint32_t(gCurLocalMS);
+		module->lastPatternTimeMS = module->GetPatternTimeMS() - periodUS / 1000;
+		module->cyclePatternTimeMS = gCurLocalMS;
+		module->InvalidateFrame();
+
+		for(int frameItr = 0; frameItr < inFrames; ++frameItr)
+		{
+			// The clock moves rather than the pattern time offset so the layers move with the pattern
+			if(frameItr > 0)
+			{
+				gCurLocalMS += periodUS / 1000;
+			}
+			Render(periodUS, ioRenderUS);
+		}
+	}
+
+	// Render two frames of inEffect eHostTestLayerElapsedMS into its period over all but the end panels and check them as a case named after the effect
+	void
+	RenderLayer(
+		CLayerEffect*	inEffect,
+		uint8_t			inBlend,
+		SPixel const&	inColor,
+		uint32_t		inParam)
+	{
+		uint32_t	renderUS = 0;
+		int			slot = module->AddLayer(inEffect, inBlend, inColor, eLEDsPerPanel, eLEDCount - 2 * eLEDsPerPanel, eHostTestLayerPeriodMS, 0, inParam);
+
+		module->layers[slot].startMS -= eHostTestLayerElapsedMS;
+		RenderPattern(2, renderUS);
+		Case(module->basePattern->GetName(), inEffect->GetName(), renderUS);
+		ClearLayers();
+	}
+
+	void
+	ClearLayers(
+		void)
+	{
+		for(int itr = 0; itr < eMaxLayers; ++itr)
+		{
+			module->layers[itr].effect = NULL;
+			module->layers[itr].span.Clear();
+			module->layerDirty[itr].Clear();
+		}
+		module->activeLayerCount = 0;
+	}
+
+	// Stream a keyframe of panel ramps, a delta that changes one panel and every fifth led, then an empty delta once a power budget is set
+	void
+	RenderStream(
+		void)
+	{
+		static uint8_t	rgb[eLEDCount * 3];
+		static uint8_t	prev[eLEDCount * 3];
+		uint8_t			sequence = 0;
+		uint32_t		renderUS = 0;
+
+		for(int itr = 0; itr < eLEDCount; ++itr)
+		{
+			int	panel = itr / eLEDsPerPanel;
+
+			rgb[itr * 3] = uint8_t(panel * 25);
+			rgb[itr * 3 + 1] = uint8_t(255 - (itr % eLEDsPerPanel) * 6);
+			rgb[itr * 3 + 2] = uint8_t(panel & 1 ? 200 : 0);
+		}
+		SendCodecFrame(rgb, NULL, sequence);
+		Render(0, renderUS);
+
+		memcpy(prev, rgb, sizeof(prev));
+		for(int itr = 0; itr < eLEDCount; ++itr)
+		{
+			if(itr / eLEDsPerPanel == 3 || itr % 5 == 0)
+			{
+				rgb[itr * 3] = 255;
+				rgb[itr * 3 + 1] = 255;
+				rgb[itr * 3 + 2] = 255;
+			}
+		}
+		SendCodecFrame(rgb, prev, sequence);
+		Render(0, renderUS);
+
+		module->settings.powerBudgetMA = eHostTestPowerBudgetMA;
+		SendCodecFrame(rgb, rgb, sequence);
+		Render(0, renderUS);
+		Case("Stream", "codec", renderUS);
+
+		module->settings.powerBudgetMA = 0;
+		module->StopStream();
+		module->rawPowerScale = 256;
+	}
+
+	// Send a frame to the module as FHFrameCodec packets of eStreamMaxPacketLEDs, a keyframe if inPrevRGB is NULL
+	void
+	SendCodecFrame(
+		uint8_t const*	inRGB,
+		uint8_t const*	inPrevRGB,
+		uint8_t&		ioSequence)
+	{
+		uint8_t	packet[eStreamMaxCodecPacketSize];
+
+		for(int firstLED = 0; firstLED < eLEDCount; firstLED += eStreamMaxPacketLEDs)
+		{
+			int	ledCount = eLEDCount - firstLED < eStreamMaxPacketLEDs ? eLEDCount - firstLED : eStreamMaxPacketLEDs;
+			int	packetSize = FrameCodecEncode(inRGB, inPrevRGB, firstLED, ledCount, firstLED + ledCount == eLEDCount, packet, sizeof(packet));
+
+			module->StreamCodecPacketReceived(ioSequence++, uint32_t(gCurLocalMS), packet, packetSize);
+		}
+	}
+
+	// Decode the drawing memory into the next frame of the case in roof order through cLEDLayout and count the lit strip positions off the layout
+	void
+	ReadFrame(
+		void)
+	{
+		static bool	onRoof[eOctoStripCount][eLEDsPerStrip];
+		uint8_t		rgb[3];
+		int			ledItr = 0;
+
+		if(frameCount++ >= eHostTestMaxFrames)
+		{
+			return;
+		}
+
+		memset(onRoof, 0, sizeof(onRoof));
+		for(int segmentItr = 0; segmentItr < cLEDSegmentCount; ++segmentItr)
+		{
+			SLEDSegment const&	segment = cLEDLayout[segmentItr];
+
+			for(int itr = 0; itr < segment.ledCount; ++itr, ++ledItr)
+			{
+				int	offset = segment.stripOffset + (segment.reversed ? segment.ledCount - 1 - itr : itr);
+
+				ReadOctoPixel(segment.strip, offset, frames[frameCount - 1] + ledItr * 3);
+				onRoof[segment.strip][offset] = true;
+			}
+		}
+
+		for(int stripItr = 0; stripItr < eOctoStripCount; ++stripItr)
+		{
+			for(int offset = 0; offset < eLEDsPerStrip; ++offset)
+			{
+				ReadOctoPixel(stripItr, offset, rgb);
+				if(onRoof[stripItr][offset] == false && (rgb[0] | rgb[1] | rgb[2]) != 0)
+				{
+					++strayCount;
+				}
+			}
+		}
+	}
+
+	// Gather the 24 bits of the led at inOffset on inStrip from the octo bit planes, msb first
+	static void
+	ReadOctoPixel(
+		int			inStrip,
+		int			inOffset,
+		uint8_t*	outRGB)
+	{
+		uint8_t const*	planes = (uint8_t const*)gLEDDrawingMemory + inOffset * eBytesPerLED;
+
+		for(int channelItr = 0; channelItr < 3; ++channelItr, planes += 8)
+		{
+			uint8_t	value = 0;
+
+			for(int bitItr = 0; bitItr < 8; ++bitItr)
+			{
+				value = uint8_t((value << 1) | ((planes[bitItr] >> inStrip) & 1));
+			}
+			outRGB[channelItr] = value;
+		}
+	}
+
+	// Encode a frame in eStreamMaxPacketLEDs packets, decode them into ioDecoded and return the bytes sent or 0 if a packet did not encode or decode
+	int
+	RoundTrip(
+		uint8_t const*	inRGB,
+		uint8_t const*	inPrevRGB,
+		uint8_t*		ioDecoded)
+	{
+		uint8_t	packet[eStreamMaxCodecPacketSize];
+		int		bytes = 0;
+
+		for(int firstLED = 0; firstLED < eLEDCount; firstLED += eStreamMaxPacketLEDs)
+		{
+			int	ledCount = eLEDCount - firstLED < eStreamMaxPacketLEDs ? eLEDCount - firstLED : eStreamMaxPacketLEDs;
+			int	packetSize = FrameCodecEncode(inRGB, inPrevRGB, firstLED, ledCount, firstLED + ledCount == eLEDCount, packet, sizeof(packet));
+			int	dirtyStart, dirtyEnd;
+
+			if(packetSize == 0 || FrameCodecDecode(packet, packetSize, ioDecoded, eLEDCount, dirtyStart, dirtyEnd) == false)
+			{
+				return 0;
+			}
+			bytes += packetSize;
+		}
+
+		return bytes;
+	}
+
+	int
+	CodecCase(
+		char const*	inName,
+		bool		inOK)
+	{
+		++cases;
+		printf("Codec %s %s\n", inName, inOK ? "ok" : "FAIL");
+
+		return inOK ? 0 : 1;
+	}
+
+	// Print the leds of a frame as runs of countxrrggbb, eHostTestRunsPerLine to a line
+	void
+	PrintFrame(
+		uint8_t const*	inRGB)
+	{
+		int	runCount = 0;
+
+		printf("\t\t\"");
+		for(int ledItr = 0; ledItr < eLEDCount; ++runCount)
+		{
+			int	runLength = 1;
+
+			while(ledItr + runLength < eLEDCount && memcmp(inRGB + ledItr * 3, inRGB + (ledItr + runLength) * 3, 3) == 0)
+			{
+				++runLength;
+			}
+
+			if(runCount > 0)
+			{
+				printf(runCount % eHostTestRunsPerLine == 0 ? " \"\n\t\t\"" : " ");
+			}
+			if(runLength > 1)
+			{
+				printf("%dx", runLength);
+			}
+			printf("%02x%02x%02x", inRGB[ledItr * 3], inRGB[ledItr * 3 + 1], inRGB[ledItr * 3 + 2]);
+			ledItr += runLength;
+		}
+		printf("\"");
+	}
+
+	// Parse a frame printed by PrintFrame() into outRGB, return false unless it has exactly eLEDCount leds
+	static bool
+	ParseFrame(
+		char const*	inText,
+		uint8_t*	outRGB)
+	{
+		int	ledItr = 0;
+
+		while(*inText != 0)
+		{
+			if(*inText == ' ')
+			{
+				++inText;
+				continue;
+			}
+
+			size_t	digits = strspn(inText, "0123456789abcdef");
+			int		runLength = 1;
+
+			if(inText[digits] == 'x')
+			{
+				runLength = atoi(inText);
+				inText += digits + 1;
+				digits = strspn(inText, "0123456789abcdef");
+			}
+
+			if(digits != 6 || runLength < 1 || ledItr + runLength > eLEDCount)
+			{
+				return false;
+			}
+
+			uint32_t	color = uint32_t(strtoul(inText, NULL, 16));
+
+			for(int itr = 0; itr < runLength; ++itr, ++ledItr)
+			{
+				outRGB[ledItr * 3] = uint8_t(color >> 16);
+				outRGB[ledItr * 3 + 1] = uint8_t(color >> 8);
+				outRGB[ledItr * 3 + 2] = uint8_t(color);
+			}
+			inText += digits;
+		}
+
+		return ledItr == eLEDCount;
+	}
+
+	void
+	PrintGolden(
+		char const*	inName,
+		char const*	inMode,
+		int			inFloatPixels,
+		uint8_t		inFrames[][eLEDCount * 3],
+		int			inFrameCount)
+	{
+		printf("\t{\"%s\", \"%s\", %d, {", inName, inMode, inFloatPixels);
+		for(int itr = 0; itr < inFrameCount; ++itr)
+		{
+			printf(itr == 0 ? "\n" : ",\n");
+			PrintFrame(inFrames[itr]);
+		}
+		printf("}},\n");
+	}
+
+	void
+	PrintOtherGoldens(
+		void)
+	{
+		static uint8_t	otherFrames[eHostTestMaxFrames][eLEDCount * 3];
+
+		for(int itr = 0; itr < int(sizeof(cRenderGoldens) / sizeof(cRenderGoldens[0])); ++itr)
+		{
+			SRenderGolden const&	golden = cRenderGoldens[itr];
+			int						otherCount = 0;
+
+			if(golden.floatPixels == MUseFloatPixels)
+			{
+				continue;
+			}
+
+			while(otherCount < eHostTestMaxFrames && golden.frames[otherCount] != NULL && ParseFrame(golden.frames[otherCount], otherFrames[otherCount]))
+			{
+				++otherCount;
+			}
+			PrintGolden(golden.name, golden.mode, golden.floatPixels, otherFrames, otherCount);
+		}
+	}
+
+	// Compare the frames rendered since the last case to the golden for the case, a mismatch names the first led that differs
+	void
+	Case(
+		char const*	inName,
+		char const*	inMode,
+		uint32_t	inRenderUS)
+	{
+		int	caseFrameCount = frameCount;
+		int	caseStrayCount = strayCount;
+
+		++cases;
+		frameCount = 0;
+		strayCount = 0;
+
+		if(caseFrameCount > eHostTestMaxFrames)
+		{
+			printf("%s %s renders %d frames, increase eHostTestMaxFrames FAIL\n", inName, inMode, caseFrameCount);
+			++failed;
+			return;
+		}
+
+		if(update)
+		{
+			PrintGolden(inName, inMode, MUseFloatPixels, frames, caseFrameCount);
+			return;
+		}
+
+		int	goldenItr;
+
+		for(goldenItr = 0; goldenItr < int(sizeof(cRenderGoldens) / sizeof(cRenderGoldens[0])); ++goldenItr)
+		{
+			if(cRenderGoldens[goldenItr].floatPixels == MUseFloatPixels && strcmp(cRenderGoldens[goldenItr].name, inName) == 0
+				&& strcmp(cRenderGoldens[goldenItr].mode, inMode) == 0)
+			{
+				break;
+			}
+		}
+
+		if(goldenItr == int(sizeof(cRenderGoldens) / sizeof(cRenderGoldens[0])))
+		{
+			printf("%s %s us=%u no golden\n", inName, inMode, inRenderUS);
+			++failed;
+			return;
+		}
+
+		SRenderGolden const&	golden = cRenderGoldens[goldenItr];
+		bool					match = caseStrayCount == 0;
+
+		goldenUsed[goldenItr] = true;
+		for(int frameItr = 0; frameItr < eHostTestMaxFrames; ++frameItr)
+		{
+			static uint8_t	goldenRGB[eLEDCount * 3];
+			bool			rendered = frameItr < caseFrameCount;
+
+			if(golden.frames[frameItr] == NULL || rendered == false)
+			{
+				if(golden.frames[frameItr] != NULL || rendered)
+				{
+					printf("%s %s frame %d %s\n", inName, inMode, frameItr, rendered ? "has no golden" : "not rendered");
+					match = false;
+				}
+				continue;
+			}
+
+			if(ParseFrame(golden.frames[frameItr], goldenRGB) == false)
+			{
+				printf("%s %s frame %d golden does not have %d leds\n", inName, inMode, frameItr, eLEDCount);
+				match = false;
+				continue;
+			}
+
+			int	firstLED = -1;
+			int	diffCount = 0;
+
+			for(int ledItr = 0; ledItr < eLEDCount; ++ledItr)
+			{
+				if(memcmp(frames[frameItr] + ledItr * 3, goldenRGB + ledItr * 3, 3) != 0)
+				{
+					firstLED = firstLED < 0 ? ledItr : firstLED;
+					++diffCount;
+				}
+			}
+
+			if(diffCount > 0)
+			{
+				uint8_t const*	rgb = frames[frameItr] + firstLED * 3;
+				uint8_t const*	expected = goldenRGB + firstLED * 3;
+
+				printf("%s %s frame %d led %d rgb=%02x%02x%02x golden=%02x%02x%02x, %d leds differ\n", inName, inMode, frameItr, firstLED,
+					rgb[0], rgb[1], rgb[2], expected[0], expected[1], expected[2], diffCount);
+				match = false;
+			}
+		}
+
+		if(caseStrayCount > 0)
+		{
+			printf("%s %s lit %d strip positions off cLEDLayout\n", inName, inMode, caseStrayCount);
+		}
+		printf("%s %s frames=%d us=%u %s\n", inName, inMode, caseFrameCount, inRenderUS, match ? "ok" : "FAIL");
+		if(match == false)
+		{
+			++failed;
+		}
+	}
+
+	bool	update;
+	int		cases;
+	int		failed;
+	bool	goldenUsed[eHostTestMaxGoldens];
+	uint8_t	frames[eHostTestMaxFrames][eLEDCount * 3];	// The frames rendered since the last case, in roof order
+	int		frameCount;
+	int		strayCount;		// The lit octo strip positions off cLEDLayout in those frames
+	CHostLuminosity	luxSensor;
+};
+
+int
+main(
+	int		inArgC,
+	char*	inArgv[])
+{
+	CHostTest	test;
+
+	if(inArgC < 2 || strcmp(inArgv[1], "check") == 0)
+	{
+		int	failed = test.Check(false) + test.CheckSync() + test.CheckCodec();
+
+		printf("%s\n", failed == 0 ? "passed" : "FAILED");
+
+		return failed == 0 ? 0 : 1;
+	}
+
+	if(strcmp(inArgv[1], "update") == 0)
+	{
+		return test.Check(true);
+	}
+
+	if(strcmp(inArgv[1], "bench") == 0)
+	{
+		return test.Bench(inArgC >= 3 ? atoi(inArgv[2]) : eHostTestBenchFrames);
+	}
+
+	printf("usage: FHHostTest [check | update | bench [frames]]\n");
+
+	return 1;
+}
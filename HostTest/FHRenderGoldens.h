@@ -0,0 +1,539 @@
+// Generated by FHHostTest update from the frames FHOutdoorLighting.cpp renders, the cases are described in FHHostTest.cpp
+
+SRenderGolden const	cRenderGoldens[] =
+{
+	{"Christmas", "cycle", 0, {
+		"38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00",
+		"38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00"}},
+	{"Valentine's Day", "cycle", 0, {
+		"380xff0000",
+		"380xff0000"}},
+	{"4th Of July", "cycle", 0, {
+		"38xff0000 38xffffff 38x0000ff 38xff0000 38xffffff 38x0000ff 38xff0000 38xffffff 38x0000ff 38xff0000",
+		"38xff0000 38xffffff 38x0000ff 38xff0000 38xffffff 38x0000ff 38xff0000 38xffffff 38x0000ff 38xff0000"}},
+	{"Halloween", "cycle", 0, {
+		"38xffa600 38x800080 38xffa600 38x800080 38xffa600 38x800080 38xffa600 38x800080 38xffa600 38x800080",
+		"38xffa600 38x800080 38xffa600 38x800080 38xffa600 38x800080 38xffa600 38x800080 38xffa600 38x800080"}},
+	{"St. Patty's Day", "cycle", 0, {
+		"380x00ff00",
+		"380x00ff00"}},
+	{"Easter", "cycle", 0, {
+		"38xffff00 38x800080 38xff0000 38x00ff00 38x0000ff 38xff69b5 38xffa600 38xffff00 38x800080 38xff0000",
+		"38xffff00 38x800080 38xff0000 38x00ff00 38x0000ff 38xff69b5 38xffa600 38xffff00 38x800080 38xff0000"}},
+	{"Chase", "cycle", 0, {
+		"8xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff "
+		"16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff "
+		"16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff "
+		"16xff0000 8xffffff 4xff0000",
+		"8xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff "
+		"16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff "
+		"16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff "
+		"16xff0000 8xffffff 4xff0000"}},
+	{"Twinkle", "cycle", 0, {
+		"17x000060 dfdfeb 30x000060 dfdfeb 37x000060 9f9fc3 3x000060 bfbfd7 64x000060 7f7faf "
+		"35x000060 1f1f73 22x000060 bfbfd7 000060 9f9fc3 44x000060 3f3f87 51x000060 5f5f9b "
+		"18x000060 7f7faf 30x000060 1f1f73 6x000060 ffffff 3x000060 5f5f9b 5x000060",
+		"17x000060 e8e8f0 30x000060 d5d5e4 37x000060 9595bc 3x000060 c8c8dc 64x000060 8989b5 "
+		"35x000060 292979 22x000060 b5b5d0 000060 a8a8c8 44x000060 49498d 12x000060 090965 "
+		"38x000060 565695 18x000060 7575a8 30x000060 16166d 6x000060 f5f5f8 3x000060 6969a1 "
+		"5x000060"}},
+	{"Color Wheel", "cycle", 0, {
+		"38x00ff00 38x00b44b 38x006699 38x001be4 38x3300cc 38x81007e 38xcc0033 38xe71800 38x9c6300 38x4eb100",
+		"38x00ff00 38x00b44b 38x006699 38x001be4 38x3300cc 38x81007e 38xcc0033 38xe71800 38x9c6300 38x4eb100"}},
+	{"Test", "step0", 0, {
+		"23x000000 0000ff 00ff00 ff0000 354x000000"}},
+	{"Test", "step1", 0, {
+		"48x000000 0000ff 00ff00 ff0000 329x000000"}},
+	{"Test", "step2", 0, {
+		"73x000000 0000ff 00ff00 ff0000 304x000000"}},
+	{"Test", "step3", 0, {
+		"98x000000 0000ff 00ff00 ff0000 279x000000"}},
+	{"Christmas", "day", 0, {
+		"38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00",
+		"38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00"}},
+	{"Christmas", "night", 0, {
+		"38x300000 38x003000 38x300000 38x003000 38x300000 38x003000 38x300000 38x003000 38x300000 38x003000",
+		"38x300000 38x003000 38x300000 38x003000 38x300000 38x003000 38x300000 38x003000 38x300000 38x003000"}},
+	{"Christmas", "dusk", 0, {
+		"38x1a0000 38x001a00 38x1a0000 38x001a00 38x1a0000 38x001a00 38x1a0000 38x001a00 38x1a0000 38x001a00",
+		"38x1a0000 38x001a00 38x1a0000 38x001a00 38x1a0000 38x001a00 38x1a0000 38x001a00 38x1a0000 38x001a00"}},
+	{"Christmas", "motion", 0, {
+		"38xbf0000 38x00bf00 38xbf0000 38x00bf00 38xbf0000 38x00bf00 38xbf0000 38x00bf00 38xbf0000 38x00bf00",
+		"38xbf0000 38x00bf00 38xbf0000 38x00bf00 38xbf0000 38x00bf00 38xbf0000 38x00bf00 38xbf0000 38x00bf00"}},
+	{"Christmas", "dither", 0, {
+		"38x3f0000 38x003f00 38x3f0000 38x003f00 38x3f0000 38x003f00 38x3f0000 38x003f00 38x3f0000 38x003f00",
+		"38x400000 38x004000 38x400000 38x004000 38x400000 38x004000 38x400000 38x004000 38x400000 38x004000",
+		"38x400000 38x004000 38x400000 38x004000 38x400000 38x004000 38x400000 38x004000 38x400000 38x004000",
+		"38x400000 38x004000 38x400000 38x004000 38x400000 38x004000 38x400000 38x004000 38x400000 38x004000"}},
+	{"Christmas", "fade", 0, {
+		"38x660000 38x006600 38x660000 38x006600 38x660000 38x006600 38x660000 38x006600 38x660000 38x006600",
+		"38x8c0000 38x008c00 38x8c0000 38x008c00 38x8c0000 38x008c00 38x8c0000 38x008c00 38x8c0000 38x008c00",
+		"38xb20000 38x00b200 38xb20000 38x00b200 38xb20000 38x00b200 38xb20000 38x00b200 38xb20000 38x00b200",
+		"38xbf0000 38x00bf00 38xbf0000 38x00bf00 38xbf0000 38x00bf00 38xbf0000 38x00bf00 38xbf0000 38x00bf00"}},
+	{"Christmas", "sweep", 0, {
+		"38xff0000 38x00ff00 38xff0000 00ff00 0cff0c 19ff19 26ff26 33ff33 3fff3f 4cff4c "
+		"59ff59 66ff66 72ff72 7fff7f 8cff8c 99ff99 a5ffa5 b2ffb2 bfffbf ccffcc "
+		"d8ffd8 e5ffe5 f2fff2 ffffff 17x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 "
+		"38x00ff00",
+		"38xff0000 38x00ff00 38xff0000 10x00ff00 0cff0c 19ff19 26ff26 33ff33 3fff3f 4cff4c "
+		"59ff59 66ff66 72ff72 7fff7f 8cff8c 99ff99 a5ffa5 b2ffb2 bfffbf ccffcc "
+		"d8ffd8 e5ffe5 f2fff2 ffffff 8x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 "
+		"38x00ff00"}},
+	{"Christmas", "sparkle", 0, {
+		"38xff0000 00ff00 00ff17 00ff2b 2x00ff00 00ffa9 00ffc8 2x00ff00 00ffe9 2x00ff00 "
+		"00ff62 00ffd7 00ff01 2x00ff00 00ff64 00ffcd 3x00ff00 00ff60 00ff00 00ff12 "
+		"00fffd 6x00ff00 00ff5b 00ffb1 00ffa2 00ff57 00fffb 00fff4 ff0036 ff0023 "
+		"ff00c8 ff00b1 ff001a 4xff0000 ff0070 ff0000 ff00b5 ff002e ff0000 ff0001 "
+		"ff0000 ff0053 ff00a2 ff0000 ff00fd 2xff0055 ff0074 ff00e0 ff0000 ff002a "
+		"2xff0000 ff00a2 ff0090 4xff0000 ff008c ff00ab 2xff0000 2x00ff00 00ff4f 00ff00 "
+		"00ffa7 00ff55 00ff60 00ff00 00ff3f 00ffea 00ff9f 00ff00 00ff45 00ffd1 "
+		"00ff00 00ffac 2x00ff00 00ff46 00ff00 00fff5 00ff00 00ffb0 2x00ff00 00ff05 "
+		"3x00ff00 00ff0d 00ff62 00ff58 4x00ff00 00ff2d 00ff11 ff0095 ff0000 ff00b4 "
+		"ff0018 ff0042 ff0000 ff00b4 ff00d4 ff00c8 ff00bc ff0000 ff0016 ff0000 "
+		"ff0083 4xff0000 ff009e ff0030 3xff0000 ff0046 ff00e4 ff0000 ff00ee ff0000 "
+		"ff0039 ff002e 3xff0000 ff00b8 ff0000 ff00e2 ff0069 ff005e 00ff9a 00ff9f "
+		"00ff6e 00ff07 3x00ff00 00ffcc 00ffd5 2x00ff00 00ffa0 3x00ff00 00ff8c 00ff6c "
+		"00ff98 00ff00 00ff10 00ff92 00ff00 00ff3d 2x00ff00 00ff92 3x00ff00 00ff71 "
+		"00ff40 00fff7 00ff00 00ff07 2x00ff00 00ff1f 00ff98 3xff0000 ff00b9 ff0000 "
+		"ff0029 ff006a ff004b ff002c ff00a9 ff0012 ff000a ff002f ff005d ff00cc "
+		"ff0077 ff0062 ff00b0 2xff0000 ff0061 ff007b ff0013 ff0088 ff0000 ff0077 "
+		"2xff0000 ff005a 2xff0000 ff00e4 ff0049 ff0000 ff001c 2xff0000 ff0046 00ff00 "
+		"00ff88 00ff46 00ff76 00ff9a 00ff00 00ffe2 00ff3d 2x00ff00 00ff6d 00ff81 "
+		"2x00ff00 00ff15 2x00ff00 00ffdf 3x00ff00 00ffc8 00ff81 2x00ff00 00ff85 00ff50 "
+		"00ff84 2x00ff00 00ff24 00ffe0 3x00ff00 00ff5a 00ff00 00ff8c ff0000 ff004e "
+		"ff0000 ff00dd 2xff0000 ff00ca ff0000 ff0016 ff008d ff0000 ff002f ff0015 "
+		"2xff0000 ff0099 ff0073 3xff0000 ff0082 ff00e0 ff0000 ff00ac 2xff0000 ff005f "
+		"2xff0000 ff00c4 4xff0000 ff0046 ff000a 2xff0000 38x00ff00",
+		"38xff0000 00ff00 00ff08 00ff3b 2x00ff00 00ffb8 00ffd7 2x00ff00 00fff8 2x00ff00 "
+		"00ff53 00ffc7 00ff0d 2x00ff00 00ff74 00ffbe 2x00ff00 00ff03 00ff6f 00ff00 "
+		"00ff21 00fff0 6x00ff00 00ff6a 00ffa2 00ffb1 00ff66 00fff2 00ffe4 ff0027 "
+		"ff0032 ff00b9 ff00a2 ff000b 4xff0000 ff0080 ff0000 ff00a6 ff001f ff0000 "
+		"ff0010 ff0000 ff0062 ff0093 ff0000 ff00f0 ff0046 ff0064 ff0065 ff00f0 "
+		"ff0000 ff003a 2xff0000 ff00b1 ff0081 4xff0000 ff007c ff00ba 2xff0000 2x00ff00 "
+		"00ff5e 00ff00 00ff98 00ff64 00ff70 00ff00 00ff4f 00ffdb 00ffae 00ff00 "
+		"00ff36 00ffe0 00ff00 00ffbb 2x00ff00 00ff37 00ff00 00fff8 00ff00 00ffc0 "
+		"2x00ff00 00ff14 3x00ff00 00ff1d 00ff53 00ff48 00ff00 00ff0a 2x00ff00 00ff1e "
+		"00ff20 ff00a4 ff0000 ff00a4 ff0009 ff0051 ff0000 ff00c3 ff00e3 ff00d8 "
+		"ff00cc ff0000 ff0007 ff0000 ff0073 4xff0000 ff00ad ff003f 2xff0000 ff0009 "
+		"ff0056 ff00f3 ff0000 ff00de ff0000 ff0029 ff001f 3xff0000 ff00c7 ff0000 "
+		"ff00d3 ff0078 ff004f 00ff8b 00ff8f 00ff5f 4x00ff00 00ffdb 00ffc5 2x00ff00 "
+		"00ff90 3x00ff00 00ff9c 00ff5d 00ffa7 00ff00 00ff20 00ffa1 00ff00 00ff2d "
+		"2x00ff00 00ff83 3x00ff00 00ff61 00ff4f 00fff6 00ff00 00ff16 2x00ff00 00ff2e "
+		"00ff89 3xff0000 ff00aa ff0005 ff0039 ff005a 2xff003c ff009a ff0021 ff001a "
+		"ff003e ff004e ff00bd ff0068 ff0072 ff00c0 2xff0000 ff0070 ff008b ff0004 "
+		"ff0097 ff0000 ff0068 2xff0000 ff0069 2xff0000 ff00f3 ff003a ff0000 ff000c "
+		"2xff0000 ff0056 00ff00 00ff78 00ff56 00ff67 00ffa9 00ff00 00ffd3 00ff2e "
+		"2x00ff00 00ff7c 00ff71 2x00ff00 00ff06 2x00ff00 00ffee 2x00ff00 00ff0c 00ffb9 "
+		"00ff90 2x00ff00 00ff94 00ff41 00ff93 2x00ff00 00ff34 00ffd1 3x00ff00 00ff6a "
+		"00ff00 00ff9c ff0000 ff003f ff0000 ff00ec 2xff0000 ff00bb ff0000 ff0025 "
+		"ff007d ff0000 ff003e ff0006 2xff0000 ff008a ff0063 3xff0000 ff0072 ff00d1 "
+		"ff0000 ff009d 2xff0000 ff006e 2xff0000 ff00d4 4xff0000 ff0056 ff0019 2xff0000 "
+		"38x00ff00"}},
+	{"Christmas", "flash", 0, {
+		"38xff0000 38x59ff59 38xff5959 38x59ff59 38xff5959 38x59ff59 38xff5959 38x59ff59 38xff5959 38x00ff00",
+		"38xff0000 38x55ff55 38xff5555 38x55ff55 38xff5555 38x55ff55 38xff5555 38x55ff55 38xff5555 38x00ff00"}},
+	{"Christmas", "power", 0, {
+		"38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00",
+		"38x580000 38x005800 38x580000 38x005800 38x580000 38x005800 38x580000 38x005800 38x580000 38x005800",
+		"38x570000 38x005700 38x570000 38x005700 38x570000 38x005700 38x570000 38x005700 38x570000 38x005700"}},
+	{"Christmas", "wave", 0, {
+		"38x400000 38x004000 38x400000 38x004000 38x400000 38x004000 38x400000 38x004000 38x400000 38x004000",
+		"38x400000 25x004000 004400 004700 004a00 004d00 005100 005500 005800 005b00 "
+		"005f00 006200 006500 006800 006c00 6f0000 730000 760000 7a0000 7d0000 "
+		"800000 830000 860000 8a0000 8e0000 910000 940000 980000 9b0000 9e0000 "
+		"a10000 a50000 a90000 ac0000 af0000 b30000 b60000 b90000 bc0000 bf0000 "
+		"bc0000 b90000 b60000 b30000 af0000 ac0000 a90000 a50000 a10000 9e0000 "
+		"9b0000 980000 940000 009100 008e00 008a00 008600 008300 008000 007d00 "
+		"007a00 007600 007300 006f00 006c00 006800 006500 006200 005f00 005b00 "
+		"005800 005500 005100 004d00 004a00 004700 004400 14x004000 38x400000 38x004000 "
+		"38x400000 38x004000 38x400000 38x004000",
+		"580000 5b0000 5f0000 620000 650000 680000 6c0000 6f0000 730000 760000 "
+		"7a0000 7d0000 800000 830000 860000 8a0000 8e0000 910000 940000 980000 "
+		"9b0000 9e0000 a10000 a50000 a90000 ac0000 af0000 b30000 b60000 b90000 "
+		"bc0000 7xbf0000 38x00bf00 38xbf0000 38x00bf00 18xbf0000 bc0000 b90000 b60000 b30000 "
+		"af0000 ac0000 a90000 a50000 a10000 9e0000 9b0000 980000 940000 910000 "
+		"8e0000 8a0000 860000 830000 800000 7d0000 007a00 007600 007300 006f00 "
+		"006c00 006800 006500 006200 005f00 005b00 005800 005500 005100 004d00 "
+		"004a00 004700 004400 21x004000 38x400000 38x004000 38x400000 38x004000",
+		"38xbf0000 38x00bf00 38xbf0000 38x00bf00 38xbf0000 38x00bf00 12xbf0000 bc0000 b90000 b60000 "
+		"b30000 af0000 ac0000 a90000 a50000 a10000 9e0000 9b0000 980000 940000 "
+		"910000 8e0000 8a0000 860000 830000 800000 7d0000 7a0000 760000 730000 "
+		"6f0000 6c0000 680000 006500 006200 005f00 005b00 005800 005500 005100 "
+		"004d00 004a00 004700 004400 27x004000 38x400000 38x004000"}},
+	{"Stream", "codec", 0, {
+		"00ff00 00f900 00f300 00ed00 00e700 00e100 00db00 00d500 00cf00 00c900 "
+		"00c300 00bd00 00b700 00b100 00ab00 00a500 009f00 009900 009300 008d00 "
+		"008700 008100 007b00 007500 006f00 006900 006300 005d00 005700 005100 "
+		"004b00 004500 003f00 003900 003300 002d00 002700 002100 19ffc8 19f9c8 "
+		"19f3c8 19edc8 19e7c8 19e1c8 19dbc8 19d5c8 19cfc8 19c9c8 19c3c8 19bdc8 "
+		"19b7c8 19b1c8 19abc8 19a5c8 199fc8 1999c8 1993c8 198dc8 1987c8 1981c8 "
+		"197bc8 1975c8 196fc8 1969c8 1963c8 195dc8 1957c8 1951c8 194bc8 1945c8 "
+		"193fc8 1939c8 1933c8 192dc8 1927c8 1921c8 32ff00 32f900 32f300 32ed00 "
+		"32e700 32e100 32db00 32d500 32cf00 32c900 32c300 32bd00 32b700 32b100 "
+		"32ab00 32a500 329f00 329900 329300 328d00 328700 328100 327b00 327500 "
+		"326f00 326900 326300 325d00 325700 325100 324b00 324500 323f00 323900 "
+		"323300 322d00 322700 322100 4bffc8 4bf9c8 4bf3c8 4bedc8 4be7c8 4be1c8 "
+		"4bdbc8 4bd5c8 4bcfc8 4bc9c8 4bc3c8 4bbdc8 4bb7c8 4bb1c8 4babc8 4ba5c8 "
+		"4b9fc8 4b99c8 4b93c8 4b8dc8 4b87c8 4b81c8 4b7bc8 4b75c8 4b6fc8 4b69c8 "
+		"4b63c8 4b5dc8 4b57c8 4b51c8 4b4bc8 4b45c8 4b3fc8 4b39c8 4b33c8 4b2dc8 "
+		"4b27c8 4b21c8 64ff00 64f900 64f300 64ed00 64e700 64e100 64db00 64d500 "
+		"64cf00 64c900 64c300 64bd00 64b700 64b100 64ab00 64a500 649f00 649900 "
+		"649300 648d00 648700 648100 647b00 647500 646f00 646900 646300 645d00 "
+		"645700 645100 644b00 644500 643f00 643900 643300 642d00 642700 642100 "
+		"7dffc8 7df9c8 7df3c8 7dedc8 7de7c8 7de1c8 7ddbc8 7dd5c8 7dcfc8 7dc9c8 "
+		"7dc3c8 7dbdc8 7db7c8 7db1c8 7dabc8 7da5c8 7d9fc8 7d99c8 7d93c8 7d8dc8 "
+		"7d87c8 7d81c8 7d7bc8 7d75c8 7d6fc8 7d69c8 7d63c8 7d5dc8 7d57c8 7d51c8 "
+		"7d4bc8 7d45c8 7d3fc8 7d39c8 7d33c8 7d2dc8 7d27c8 7d21c8 96ff00 96f900 "
+		"96f300 96ed00 96e700 96e100 96db00 96d500 96cf00 96c900 96c300 96bd00 "
+		"96b700 96b100 96ab00 96a500 969f00 969900 969300 968d00 968700 968100 "
+		"967b00 967500 966f00 966900 966300 965d00 965700 965100 964b00 964500 "
+		"963f00 963900 963300 962d00 962700 962100 afffc8 aff9c8 aff3c8 afedc8 "
+		"afe7c8 afe1c8 afdbc8 afd5c8 afcfc8 afc9c8 afc3c8 afbdc8 afb7c8 afb1c8 "
+		"afabc8 afa5c8 af9fc8 af99c8 af93c8 af8dc8 af87c8 af81c8 af7bc8 af75c8 "
+		"af6fc8 af69c8 af63c8 af5dc8 af57c8 af51c8 af4bc8 af45c8 af3fc8 af39c8 "
+		"af33c8 af2dc8 af27c8 af21c8 c8ff00 c8f900 c8f300 c8ed00 c8e700 c8e100 "
+		"c8db00 c8d500 c8cf00 c8c900 c8c300 c8bd00 c8b700 c8b100 c8ab00 c8a500 "
+		"c89f00 c89900 c89300 c88d00 c88700 c88100 c87b00 c87500 c86f00 c86900 "
+		"c86300 c85d00 c85700 c85100 c84b00 c84500 c83f00 c83900 c83300 c82d00 "
+		"c82700 c82100 e1ffc8 e1f9c8 e1f3c8 e1edc8 e1e7c8 e1e1c8 e1dbc8 e1d5c8 "
+		"e1cfc8 e1c9c8 e1c3c8 e1bdc8 e1b7c8 e1b1c8 e1abc8 e1a5c8 e19fc8 e199c8 "
+		"e193c8 e18dc8 e187c8 e181c8 e17bc8 e175c8 e16fc8 e169c8 e163c8 e15dc8 "
+		"e157c8 e151c8 e14bc8 e145c8 e13fc8 e139c8 e133c8 e12dc8 e127c8 e121c8",
+		"ffffff 00f900 00f300 00ed00 00e700 ffffff 00db00 00d500 00cf00 00c900 "
+		"ffffff 00bd00 00b700 00b100 00ab00 ffffff 009f00 009900 009300 008d00 "
+		"ffffff 008100 007b00 007500 006f00 ffffff 006300 005d00 005700 005100 "
+		"ffffff 004500 003f00 003900 003300 ffffff 002700 002100 19ffc8 19f9c8 "
+		"ffffff 19edc8 19e7c8 19e1c8 19dbc8 ffffff 19cfc8 19c9c8 19c3c8 19bdc8 "
+		"ffffff 19b1c8 19abc8 19a5c8 199fc8 ffffff 1993c8 198dc8 1987c8 1981c8 "
+		"ffffff 1975c8 196fc8 1969c8 1963c8 ffffff 1957c8 1951c8 194bc8 1945c8 "
+		"ffffff 1939c8 1933c8 192dc8 1927c8 ffffff 32ff00 32f900 32f300 32ed00 "
+		"ffffff 32e100 32db00 32d500 32cf00 ffffff 32c300 32bd00 32b700 32b100 "
+		"ffffff 32a500 329f00 329900 329300 ffffff 328700 328100 327b00 327500 "
+		"ffffff 326900 326300 325d00 325700 ffffff 324b00 324500 323f00 323900 "
+		"ffffff 322d00 322700 322100 38xffffff 64ff00 64f900 64f300 ffffff 64e700 "
+		"64e100 64db00 64d500 ffffff 64c900 64c300 64bd00 64b700 ffffff 64ab00 "
+		"64a500 649f00 649900 ffffff 648d00 648700 648100 647b00 ffffff 646f00 "
+		"646900 646300 645d00 ffffff 645100 644b00 644500 643f00 ffffff 643300 "
+		"642d00 642700 642100 ffffff 7df9c8 7df3c8 7dedc8 7de7c8 ffffff 7ddbc8 "
+		"7dd5c8 7dcfc8 7dc9c8 ffffff 7dbdc8 7db7c8 7db1c8 7dabc8 ffffff 7d9fc8 "
+		"7d99c8 7d93c8 7d8dc8 ffffff 7d81c8 7d7bc8 7d75c8 7d6fc8 ffffff 7d63c8 "
+		"7d5dc8 7d57c8 7d51c8 ffffff 7d45c8 7d3fc8 7d39c8 7d33c8 ffffff 7d27c8 "
+		"7d21c8 96ff00 96f900 ffffff 96ed00 96e700 96e100 96db00 ffffff 96cf00 "
+		"96c900 96c300 96bd00 ffffff 96b100 96ab00 96a500 969f00 ffffff 969300 "
+		"968d00 968700 968100 ffffff 967500 966f00 966900 966300 ffffff 965700 "
+		"965100 964b00 964500 ffffff 963900 963300 962d00 962700 ffffff afffc8 "
+		"aff9c8 aff3c8 afedc8 ffffff afe1c8 afdbc8 afd5c8 afcfc8 ffffff afc3c8 "
+		"afbdc8 afb7c8 afb1c8 ffffff afa5c8 af9fc8 af99c8 af93c8 ffffff af87c8 "
+		"af81c8 af7bc8 af75c8 ffffff af69c8 af63c8 af5dc8 af57c8 ffffff af4bc8 "
+		"af45c8 af3fc8 af39c8 ffffff af2dc8 af27c8 af21c8 c8ff00 ffffff c8f300 "
+		"c8ed00 c8e700 c8e100 ffffff c8d500 c8cf00 c8c900 c8c300 ffffff c8b700 "
+		"c8b100 c8ab00 c8a500 ffffff c89900 c89300 c88d00 c88700 ffffff c87b00 "
+		"c87500 c86f00 c86900 ffffff c85d00 c85700 c85100 c84b00 ffffff c83f00 "
+		"c83900 c83300 c82d00 ffffff c82100 e1ffc8 e1f9c8 e1f3c8 ffffff e1e7c8 "
+		"e1e1c8 e1dbc8 e1d5c8 ffffff e1c9c8 e1c3c8 e1bdc8 e1b7c8 ffffff e1abc8 "
+		"e1a5c8 e19fc8 e199c8 ffffff e18dc8 e187c8 e181c8 e17bc8 ffffff e16fc8 "
+		"e169c8 e163c8 e15dc8 ffffff e151c8 e14bc8 e145c8 e13fc8 ffffff e133c8 "
+		"e12dc8 e127c8 e121c8",
+		"2f2f2f 002e00 002d00 002c00 002b00 2f2f2f 002900 002700 002600 002500 "
+		"2f2f2f 002300 002200 002100 002000 2f2f2f 001d00 001c00 001b00 001a00 "
+		"2f2f2f 001800 001700 001500 001400 2f2f2f 001200 001100 001000 000f00 "
+		"2f2f2f 000c00 000b00 000a00 000900 2f2f2f 000700 000600 042f25 042e25 "
+		"2f2f2f 042c25 042b25 042a25 042925 2f2f2f 042625 042525 042425 042325 "
+		"2f2f2f 042125 042025 041e25 041d25 2f2f2f 041b25 041a25 041925 041825 "
+		"2f2f2f 041525 041425 041325 041225 2f2f2f 041025 040f25 040e25 040c25 "
+		"2f2f2f 040a25 040925 040825 040725 2f2f2f 092f00 092e00 092d00 092c00 "
+		"2f2f2f 092a00 092900 092700 092600 2f2f2f 092400 092300 092200 092100 "
+		"2f2f2f 091e00 091d00 091c00 091b00 2f2f2f 091900 091800 091700 091500 "
+		"2f2f2f 091300 091200 091100 091000 2f2f2f 090e00 090c00 090b00 090a00 "
+		"2f2f2f 090800 090700 090600 38x2f2f2f 122f00 122e00 122d00 2f2f2f 122b00 "
+		"122a00 122900 122700 2f2f2f 122500 122400 122300 122200 2f2f2f 122000 "
+		"121e00 121d00 121c00 2f2f2f 121a00 121900 121800 121700 2f2f2f 121400 "
+		"121300 121200 121100 2f2f2f 120f00 120e00 120c00 120b00 2f2f2f 120900 "
+		"120800 120700 120600 2f2f2f 172e25 172d25 172c25 172b25 2f2f2f 172925 "
+		"172725 172625 172525 2f2f2f 172325 172225 172125 172025 2f2f2f 171d25 "
+		"171c25 171b25 171a25 2f2f2f 171825 171725 171525 171425 2f2f2f 171225 "
+		"171125 171025 170f25 2f2f2f 170c25 170b25 170a25 170925 2f2f2f 170725 "
+		"170625 1c2f00 1c2e00 2f2f2f 1c2c00 1c2b00 1c2a00 1c2900 2f2f2f 1c2600 "
+		"1c2500 1c2400 1c2300 2f2f2f 1c2100 1c2000 1c1e00 1c1d00 2f2f2f 1c1b00 "
+		"1c1a00 1c1900 1c1800 2f2f2f 1c1500 1c1400 1c1300 1c1200 2f2f2f 1c1000 "
+		"1c0f00 1c0e00 1c0c00 2f2f2f 1c0a00 1c0900 1c0800 1c0700 2f2f2f 202f25 "
+		"202e25 202d25 202c25 2f2f2f 202a25 202925 202725 202625 2f2f2f 202425 "
+		"202325 202225 202125 2f2f2f 201e25 201d25 201c25 201b25 2f2f2f 201925 "
+		"201825 201725 201525 2f2f2f 201325 201225 201125 201025 2f2f2f 200e25 "
+		"200c25 200b25 200a25 2f2f2f 200825 200725 200625 252f00 2f2f2f 252d00 "
+		"252c00 252b00 252a00 2f2f2f 252700 252600 252500 252400 2f2f2f 252200 "
+		"252100 252000 251e00 2f2f2f 251c00 251b00 251a00 251900 2f2f2f 251700 "
+		"251500 251400 251300 2f2f2f 251100 251000 250f00 250e00 2f2f2f 250b00 "
+		"250a00 250900 250800 2f2f2f 250600 2a2f25 2a2e25 2a2d25 2f2f2f 2a2b25 "
+		"2a2a25 2a2925 2a2725 2f2f2f 2a2525 2a2425 2a2325 2a2225 2f2f2f 2a2025 "
+		"2a1e25 2a1d25 2a1c25 2f2f2f 2a1a25 2a1925 2a1825 2a1725 2f2f2f 2a1425 "
+		"2a1325 2a1225 2a1125 2f2f2f 2a0f25 2a0e25 2a0c25 2a0b25 2f2f2f 2a0925 "
+		"2a0825 2a0725 2a0625"}},
+	{"Christmas", "cycle", 1, {
+		"38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00",
+		"38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00"}},
+	{"Valentine's Day", "cycle", 1, {
+		"380xff0000",
+		"380xff0000"}},
+	{"4th Of July", "cycle", 1, {
+		"38xff0000 38xffffff 38x0000ff 38xff0000 38xffffff 38x0000ff 38xff0000 38xffffff 38x0000ff 38xff0000",
+		"38xff0000 38xffffff 38x0000ff 38xff0000 38xffffff 38x0000ff 38xff0000 38xffffff 38x0000ff 38xff0000"}},
+	{"Halloween", "cycle", 1, {
+		"38xffa500 38x7f007f 38xffa500 38x7f007f 38xffa500 38x7f007f 38xffa500 38x7f007f 38xffa500 38x7f007f",
+		"38xffa500 38x7f007f 38xffa500 38x7f007f 38xffa500 38x7f007f 38xffa500 38x7f007f 38xffa500 38x7f007f"}},
+	{"St. Patty's Day", "cycle", 1, {
+		"380x00ff00",
+		"380x00ff00"}},
+	{"Easter", "cycle", 1, {
+		"38xffff00 38x7f007f 38xff0000 38x00ff00 38x0000ff 38xff68b5 38xffa500 38xffff00 38x7f007f 38xff0000",
+		"38xffff00 38x7f007f 38xff0000 38x00ff00 38x0000ff 38xff68b5 38xffa500 38xffff00 38x7f007f 38xff0000"}},
+	{"Chase", "cycle", 1, {
+		"8xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff "
+		"16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff "
+		"16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff "
+		"16xff0000 8xffffff 4xff0000",
+		"8xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff "
+		"16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff "
+		"16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff 16xff0000 8xffffff "
+		"16xff0000 8xffffff 4xff0000"}},
+	{"Twinkle", "cycle", 1, {
+		"17x000060 dfdfeb 30x000060 dfdfeb 37x000060 9f9fc3 3x000060 bfbfd7 64x000060 7f7faf "
+		"35x000060 1f1f73 22x000060 bfbfd7 000060 9f9fc3 44x000060 3f3f87 51x000060 5f5f9b "
+		"18x000060 7f7faf 30x000060 1f1f73 6x000060 ffffff 3x000060 5f5f9b 5x000060",
+		"17x000060 e8e8f0 30x000060 d5d5e4 37x000060 9595bc 3x000060 c8c8dc 64x000060 8989b5 "
+		"35x000060 292979 22x000060 b5b5d0 000060 a8a8c8 44x000060 49498d 12x000060 090965 "
+		"38x000060 565695 18x000060 7575a8 30x000060 16166d 6x000060 f5f5f8 3x000060 6969a1 "
+		"5x000060"}},
+	{"Color Wheel", "cycle", 1, {
+		"38x00ff00 38x00b44b 38x006699 38x001be4 38x3300cc 38x81007e 38xcc0033 38xe71800 38x9c6300 38x4eb100",
+		"38x00ff00 38x00b44b 38x006699 38x001be4 38x3300cc 38x81007e 38xcc0033 38xe71800 38x9c6300 38x4eb100"}},
+	{"Test", "step0", 1, {
+		"23x000000 0000ff 00ff00 ff0000 354x000000"}},
+	{"Test", "step1", 1, {
+		"48x000000 0000ff 00ff00 ff0000 329x000000"}},
+	{"Test", "step2", 1, {
+		"73x000000 0000ff 00ff00 ff0000 304x000000"}},
+	{"Test", "step3", 1, {
+		"98x000000 0000ff 00ff00 ff0000 279x000000"}},
+	{"Christmas", "day", 1, {
+		"38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00",
+		"38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00"}},
+	{"Christmas", "night", 1, {
+		"38x300000 38x003000 38x300000 38x003000 38x300000 38x003000 38x300000 38x003000 38x300000 38x003000",
+		"38x300000 38x003000 38x300000 38x003000 38x300000 38x003000 38x300000 38x003000 38x300000 38x003000"}},
+	{"Christmas", "dusk", 1, {
+		"38x1a0000 38x001a00 38x1a0000 38x001a00 38x1a0000 38x001a00 38x1a0000 38x001a00 38x1a0000 38x001a00",
+		"38x1a0000 38x001a00 38x1a0000 38x001a00 38x1a0000 38x001a00 38x1a0000 38x001a00 38x1a0000 38x001a00"}},
+	{"Christmas", "motion", 1, {
+		"38xbf0000 38x00bf00 38xbf0000 38x00bf00 38xbf0000 38x00bf00 38xbf0000 38x00bf00 38xbf0000 38x00bf00",
+		"38xbf0000 38x00bf00 38xbf0000 38x00bf00 38xbf0000 38x00bf00 38xbf0000 38x00bf00 38xbf0000 38x00bf00"}},
+	{"Christmas", "dither", 1, {
+		"38x3f0000 38x003f00 38x3f0000 38x003f00 38x3f0000 38x003f00 38x3f0000 38x003f00 38x3f0000 38x003f00",
+		"38x400000 38x004000 38x400000 38x004000 38x400000 38x004000 38x400000 38x004000 38x400000 38x004000",
+		"38x400000 38x004000 38x400000 38x004000 38x400000 38x004000 38x400000 38x004000 38x400000 38x004000",
+		"38x400000 38x004000 38x400000 38x004000 38x400000 38x004000 38x400000 38x004000 38x400000 38x004000"}},
+	{"Christmas", "fade", 1, {
+		"38x660000 38x006600 38x660000 38x006600 38x660000 38x006600 38x660000 38x006600 38x660000 38x006600",
+		"38x8c0000 38x008c00 38x8c0000 38x008c00 38x8c0000 38x008c00 38x8c0000 38x008c00 38x8c0000 38x008c00",
+		"38xb20000 38x00b200 38xb20000 38x00b200 38xb20000 38x00b200 38xb20000 38x00b200 38xb20000 38x00b200",
+		"38xbf0000 38x00bf00 38xbf0000 38x00bf00 38xbf0000 38x00bf00 38xbf0000 38x00bf00 38xbf0000 38x00bf00"}},
+	{"Christmas", "sweep", 1, {
+		"38xff0000 38x00ff00 38xff0000 00ff00 0cff0c 19ff19 26ff26 33ff33 3fff3f 4cff4c "
+		"59ff59 66ff66 72ff72 7fff7f 8cff8c 99ff99 a5ffa5 b2ffb2 bfffbf ccffcc "
+		"d8ffd8 e5ffe5 f2fff2 ffffff 17x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 "
+		"38x00ff00",
+		"38xff0000 38x00ff00 38xff0000 10x00ff00 0cff0c 19ff19 26ff26 33ff33 3fff3f 4cff4c "
+		"59ff59 66ff66 72ff72 7fff7f 8cff8c 99ff99 a5ffa5 b2ffb2 bfffbf ccffcc "
+		"d8ffd8 e5ffe5 f2fff2 ffffff 8x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 "
+		"38x00ff00"}},
+	{"Christmas", "sparkle", 1, {
+		"38xff0000 00ff00 00ff17 00ff2b 2x00ff00 00ffa9 00ffc8 2x00ff00 00ffe9 2x00ff00 "
+		"00ff62 00ffd7 00ff01 2x00ff00 00ff64 00ffcd 3x00ff00 00ff60 00ff00 00ff12 "
+		"00fffd 6x00ff00 00ff5b 00ffb1 00ffa2 00ff57 00fffb 00fff4 ff0036 ff0023 "
+		"ff00c8 ff00b1 ff001a 4xff0000 ff0070 ff0000 ff00b5 ff002e ff0000 ff0001 "
+		"ff0000 ff0053 ff00a2 ff0000 ff00fd 2xff0055 ff0074 ff00e0 ff0000 ff002a "
+		"2xff0000 ff00a2 ff0090 4xff0000 ff008c ff00ab 2xff0000 2x00ff00 00ff4f 00ff00 "
+		"00ffa7 00ff55 00ff60 00ff00 00ff3f 00ffea 00ff9f 00ff00 00ff45 00ffd1 "
+		"00ff00 00ffac 2x00ff00 00ff46 00ff00 00fff5 00ff00 00ffb0 2x00ff00 00ff05 "
+		"3x00ff00 00ff0d 00ff62 00ff58 4x00ff00 00ff2d 00ff11 ff0095 ff0000 ff00b4 "
+		"ff0018 ff0042 ff0000 ff00b4 ff00d4 ff00c8 ff00bc ff0000 ff0016 ff0000 "
+		"ff0083 4xff0000 ff009e ff0030 3xff0000 ff0046 ff00e4 ff0000 ff00ee ff0000 "
+		"ff0039 ff002e 3xff0000 ff00b8 ff0000 ff00e2 ff0069 ff005e 00ff9a 00ff9f "
+		"00ff6e 00ff07 3x00ff00 00ffcc 00ffd5 2x00ff00 00ffa0 3x00ff00 00ff8c 00ff6c "
+		"00ff98 00ff00 00ff10 00ff92 00ff00 00ff3d 2x00ff00 00ff92 3x00ff00 00ff71 "
+		"00ff40 00fff7 00ff00 00ff07 2x00ff00 00ff1f 00ff98 3xff0000 ff00b9 ff0000 "
+		"ff0029 ff006a ff004b ff002c ff00a9 ff0012 ff000a ff002f ff005d ff00cc "
+		"ff0077 ff0062 ff00b0 2xff0000 ff0061 ff007b ff0013 ff0088 ff0000 ff0077 "
+		"2xff0000 ff005a 2xff0000 ff00e4 ff0049 ff0000 ff001c 2xff0000 ff0046 00ff00 "
+		"00ff88 00ff46 00ff76 00ff9a 00ff00 00ffe2 00ff3d 2x00ff00 00ff6d 00ff81 "
+		"2x00ff00 00ff15 2x00ff00 00ffdf 3x00ff00 00ffc8 00ff81 2x00ff00 00ff85 00ff50 "
+		"00ff84 2x00ff00 00ff24 00ffe0 3x00ff00 00ff5a 00ff00 00ff8c ff0000 ff004e "
+		"ff0000 ff00dd 2xff0000 ff00ca ff0000 ff0016 ff008d ff0000 ff002f ff0015 "
+		"2xff0000 ff0099 ff0073 3xff0000 ff0082 ff00e0 ff0000 ff00ac 2xff0000 ff005f "
+		"2xff0000 ff00c4 4xff0000 ff0046 ff000a 2xff0000 38x00ff00",
+		"38xff0000 00ff00 00ff08 00ff3b 2x00ff00 00ffb8 00ffd7 2x00ff00 00fff8 2x00ff00 "
+		"00ff53 00ffc7 00ff0d 2x00ff00 00ff74 00ffbe 2x00ff00 00ff03 00ff6f 00ff00 "
+		"00ff21 00fff0 6x00ff00 00ff6a 00ffa2 00ffb1 00ff66 00fff2 00ffe4 ff0027 "
+		"ff0032 ff00b9 ff00a2 ff000b 4xff0000 ff0080 ff0000 ff00a6 ff001f ff0000 "
+		"ff0010 ff0000 ff0062 ff0093 ff0000 ff00f0 ff0046 ff0064 ff0065 ff00f0 "
+		"ff0000 ff003a 2xff0000 ff00b1 ff0081 4xff0000 ff007c ff00ba 2xff0000 2x00ff00 "
+		"00ff5e 00ff00 00ff98 00ff64 00ff70 00ff00 00ff4f 00ffdb 00ffae 00ff00 "
+		"00ff36 00ffe0 00ff00 00ffbb 2x00ff00 00ff37 00ff00 00fff8 00ff00 00ffc0 "
+		"2x00ff00 00ff14 3x00ff00 00ff1d 00ff53 00ff48 00ff00 00ff0a 2x00ff00 00ff1e "
+		"00ff20 ff00a4 ff0000 ff00a4 ff0009 ff0051 ff0000 ff00c3 ff00e3 ff00d8 "
+		"ff00cc ff0000 ff0007 ff0000 ff0073 4xff0000 ff00ad ff003f 2xff0000 ff0009 "
+		"ff0056 ff00f3 ff0000 ff00de ff0000 ff0029 ff001f 3xff0000 ff00c7 ff0000 "
+		"ff00d3 ff0078 ff004f 00ff8b 00ff8f 00ff5f 4x00ff00 00ffdb 00ffc5 2x00ff00 "
+		"00ff90 3x00ff00 00ff9c 00ff5d 00ffa7 00ff00 00ff20 00ffa1 00ff00 00ff2d "
+		"2x00ff00 00ff83 3x00ff00 00ff61 00ff4f 00fff6 00ff00 00ff16 2x00ff00 00ff2e "
+		"00ff89 3xff0000 ff00aa ff0005 ff0039 ff005a 2xff003c ff009a ff0021 ff001a "
+		"ff003e ff004e ff00bd ff0068 ff0072 ff00c0 2xff0000 ff0070 ff008b ff0004 "
+		"ff0097 ff0000 ff0068 2xff0000 ff0069 2xff0000 ff00f3 ff003a ff0000 ff000c "
+		"2xff0000 ff0056 00ff00 00ff78 00ff56 00ff67 00ffa9 00ff00 00ffd3 00ff2e "
+		"2x00ff00 00ff7c 00ff71 2x00ff00 00ff06 2x00ff00 00ffee 2x00ff00 00ff0c 00ffb9 "
+		"00ff90 2x00ff00 00ff94 00ff41 00ff93 2x00ff00 00ff34 00ffd1 3x00ff00 00ff6a "
+		"00ff00 00ff9c ff0000 ff003f ff0000 ff00ec 2xff0000 ff00bb ff0000 ff0025 "
+		"ff007d ff0000 ff003e ff0006 2xff0000 ff008a ff0063 3xff0000 ff0072 ff00d1 "
+		"ff0000 ff009d 2xff0000 ff006e 2xff0000 ff00d4 4xff0000 ff0056 ff0019 2xff0000 "
+		"38x00ff00"}},
+	{"Christmas", "flash", 1, {
+		"38xff0000 38x59ff59 38xff5959 38x59ff59 38xff5959 38x59ff59 38xff5959 38x59ff59 38xff5959 38x00ff00",
+		"38xff0000 38x55ff55 38xff5555 38x55ff55 38xff5555 38x55ff55 38xff5555 38x55ff55 38xff5555 38x00ff00"}},
+	{"Christmas", "power", 1, {
+		"38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00 38xff0000 38x00ff00",
+		"38x580000 38x005800 38x580000 38x005800 38x580000 38x005800 38x580000 38x005800 38x580000 38x005800",
+		"38x570000 38x005700 38x570000 38x005700 38x570000 38x005700 38x570000 38x005700 38x570000 38x005700"}},
+	{"Christmas", "wave", 1, {
+		"38x400000 38x004000 38x400000 38x004000 38x400000 38x004000 38x400000 38x004000 38x400000 38x004000",
+		"38x400000 25x004000 004300 004700 004a00 004d00 005000 005400 005700 005b00 "
+		"005e00 006200 006500 006800 006b00 6e0000 720000 760000 790000 7c0000 "
+		"800000 830000 860000 890000 8d0000 910000 940000 970000 9b0000 9e0000 "
+		"a10000 a40000 a80000 ab0000 af0000 b20000 b50000 b90000 bc0000 bf0000 "
+		"bc0000 b90000 b50000 b20000 af0000 ab0000 a80000 a40000 a10000 9e0000 "
+		"9b0000 970000 940000 009100 008d00 008900 008600 008300 008000 007c00 "
+		"007900 007600 007200 006e00 006b00 006800 006500 006200 005e00 005b00 "
+		"005700 005400 005000 004d00 004a00 004700 004300 14x004000 38x400000 38x004000 "
+		"38x400000 38x004000 38x400000 38x004000",
+		"570000 5b0000 5e0000 620000 650000 680000 6b0000 6e0000 720000 760000 "
+		"790000 7c0000 800000 830000 860000 890000 8d0000 910000 940000 970000 "
+		"9b0000 9e0000 a10000 a40000 a80000 ab0000 af0000 b20000 b50000 b90000 "
+		"bc0000 7xbf0000 38x00bf00 38xbf0000 38x00bf00 18xbf0000 bc0000 b90000 b50000 b20000 "
+		"af0000 ab0000 a80000 a40000 a10000 9e0000 9b0000 970000 940000 910000 "
+		"8d0000 890000 860000 830000 800000 7c0000 007900 007600 007200 006e00 "
+		"006b00 006800 006500 006200 005e00 005b00 005700 005400 005000 004d00 "
+		"004a00 004700 004300 21x004000 38x400000 38x004000 38x400000 38x004000",
+		"38xbf0000 38x00bf00 38xbf0000 38x00bf00 38xbf0000 38x00bf00 12xbf0000 bc0000 b90000 b50000 "
+		"b20000 af0000 ab0000 a80000 a40000 a10000 9e0000 9b0000 970000 940000 "
+		"910000 8d0000 890000 860000 830000 800000 7c0000 790000 760000 720000 "
+		"6e0000 6b0000 680000 006500 006200 005e00 005b00 005700 005400 005000 "
+		"004d00 004a00 004700 004300 27x004000 38x400000 38x004000"}},
+	{"Stream", "codec", 1, {
+		"00ff00 00f900 00f300 00ed00 00e700 00e100 00db00 00d500 00cf00 00c900 "
+		"00c300 00bd00 00b700 00b100 00ab00 00a500 009f00 009900 009300 008d00 "
+		"008700 008100 007b00 007500 006f00 006900 006300 005d00 005700 005100 "
+		"004b00 004500 003f00 003900 003300 002d00 002700 002100 19ffc8 19f9c8 "
+		"19f3c8 19edc8 19e7c8 19e1c8 19dbc8 19d5c8 19cfc8 19c9c8 19c3c8 19bdc8 "
+		"19b7c8 19b1c8 19abc8 19a5c8 199fc8 1999c8 1993c8 198dc8 1987c8 1981c8 "
+		"197bc8 1975c8 196fc8 1969c8 1963c8 195dc8 1957c8 1951c8 194bc8 1945c8 "
+		"193fc8 1939c8 1933c8 192dc8 1927c8 1921c8 32ff00 32f900 32f300 32ed00 "
+		"32e700 32e100 32db00 32d500 32cf00 32c900 32c300 32bd00 32b700 32b100 "
+		"32ab00 32a500 329f00 329900 329300 328d00 328700 328100 327b00 327500 "
+		"326f00 326900 326300 325d00 325700 325100 324b00 324500 323f00 323900 "
+		"323300 322d00 322700 322100 4bffc8 4bf9c8 4bf3c8 4bedc8 4be7c8 4be1c8 "
+		"4bdbc8 4bd5c8 4bcfc8 4bc9c8 4bc3c8 4bbdc8 4bb7c8 4bb1c8 4babc8 4ba5c8 "
+		"4b9fc8 4b99c8 4b93c8 4b8dc8 4b87c8 4b81c8 4b7bc8 4b75c8 4b6fc8 4b69c8 "
+		"4b63c8 4b5dc8 4b57c8 4b51c8 4b4bc8 4b45c8 4b3fc8 4b39c8 4b33c8 4b2dc8 "
+		"4b27c8 4b21c8 64ff00 64f900 64f300 64ed00 64e700 64e100 64db00 64d500 "
+		"64cf00 64c900 64c300 64bd00 64b700 64b100 64ab00 64a500 649f00 649900 "
+		"649300 648d00 648700 648100 647b00 647500 646f00 646900 646300 645d00 "
+		"645700 645100 644b00 644500 643f00 643900 643300 642d00 642700 642100 "
+		"7dffc8 7df9c8 7df3c8 7dedc8 7de7c8 7de1c8 7ddbc8 7dd5c8 7dcfc8 7dc9c8 "
+		"7dc3c8 7dbdc8 7db7c8 7db1c8 7dabc8 7da5c8 7d9fc8 7d99c8 7d93c8 7d8dc8 "
+		"7d87c8 7d81c8 7d7bc8 7d75c8 7d6fc8 7d69c8 7d63c8 7d5dc8 7d57c8 7d51c8 "
+		"7d4bc8 7d45c8 7d3fc8 7d39c8 7d33c8 7d2dc8 7d27c8 7d21c8 96ff00 96f900 "
+		"96f300 96ed00 96e700 96e100 96db00 96d500 96cf00 96c900 96c300 96bd00 "
+		"96b700 96b100 96ab00 96a500 969f00 969900 969300 968d00 968700 968100 "
+		"967b00 967500 966f00 966900 966300 965d00 965700 965100 964b00 964500 "
+		"963f00 963900 963300 962d00 962700 962100 afffc8 aff9c8 aff3c8 afedc8 "
+		"afe7c8 afe1c8 afdbc8 afd5c8 afcfc8 afc9c8 afc3c8 afbdc8 afb7c8 afb1c8 "
+		"afabc8 afa5c8 af9fc8 af99c8 af93c8 af8dc8 af87c8 af81c8 af7bc8 af75c8 "
+		"af6fc8 af69c8 af63c8 af5dc8 af57c8 af51c8 af4bc8 af45c8 af3fc8 af39c8 "
+		"af33c8 af2dc8 af27c8 af21c8 c8ff00 c8f900 c8f300 c8ed00 c8e700 c8e100 "
+		"c8db00 c8d500 c8cf00 c8c900 c8c300 c8bd00 c8b700 c8b100 c8ab00 c8a500 "
+		"c89f00 c89900 c89300 c88d00 c88700 c88100 c87b00 c87500 c86f00 c86900 "
+		"c86300 c85d00 c85700 c85100 c84b00 c84500 c83f00 c83900 c83300 c82d00 "
+		"c82700 c82100 e1ffc8 e1f9c8 e1f3c8 e1edc8 e1e7c8 e1e1c8 e1dbc8 e1d5c8 "
+		"e1cfc8 e1c9c8 e1c3c8 e1bdc8 e1b7c8 e1b1c8 e1abc8 e1a5c8 e19fc8 e199c8 "
+		"e193c8 e18dc8 e187c8 e181c8 e17bc8 e175c8 e16fc8 e169c8 e163c8 e15dc8 "
+		"e157c8 e151c8 e14bc8 e145c8 e13fc8 e139c8 e133c8 e12dc8 e127c8 e121c8",
+		"ffffff 00f900 00f300 00ed00 00e700 ffffff 00db00 00d500 00cf00 00c900 "
+		"ffffff 00bd00 00b700 00b100 00ab00 ffffff 009f00 009900 009300 008d00 "
+		"ffffff 008100 007b00 007500 006f00 ffffff 006300 005d00 005700 005100 "
+		"ffffff 004500 003f00 003900 003300 ffffff 002700 002100 19ffc8 19f9c8 "
+		"ffffff 19edc8 19e7c8 19e1c8 19dbc8 ffffff 19cfc8 19c9c8 19c3c8 19bdc8 "
+		"ffffff 19b1c8 19abc8 19a5c8 199fc8 ffffff 1993c8 198dc8 1987c8 1981c8 "
+		"ffffff 1975c8 196fc8 1969c8 1963c8 ffffff 1957c8 1951c8 194bc8 1945c8 "
+		"ffffff 1939c8 1933c8 192dc8 1927c8 ffffff 32ff00 32f900 32f300 32ed00 "
+		"ffffff 32e100 32db00 32d500 32cf00 ffffff 32c300 32bd00 32b700 32b100 "
+		"ffffff 32a500 329f00 329900 329300 ffffff 328700 328100 327b00 327500 "
+		"ffffff 326900 326300 325d00 325700 ffffff 324b00 324500 323f00 323900 "
+		"ffffff 322d00 322700 322100 38xffffff 64ff00 64f900 64f300 ffffff 64e700 "
+		"64e100 64db00 64d500 ffffff 64c900 64c300 64bd00 64b700 ffffff 64ab00 "
+		"64a500 649f00 649900 ffffff 648d00 648700 648100 647b00 ffffff 646f00 "
+		"646900 646300 645d00 ffffff 645100 644b00 644500 643f00 ffffff 643300 "
+		"642d00 642700 642100 ffffff 7df9c8 7df3c8 7dedc8 7de7c8 ffffff 7ddbc8 "
+		"7dd5c8 7dcfc8 7dc9c8 ffffff 7dbdc8 7db7c8 7db1c8 7dabc8 ffffff 7d9fc8 "
+		"7d99c8 7d93c8 7d8dc8 ffffff 7d81c8 7d7bc8 7d75c8 7d6fc8 ffffff 7d63c8 "
+		"7d5dc8 7d57c8 7d51c8 ffffff 7d45c8 7d3fc8 7d39c8 7d33c8 ffffff 7d27c8 "
+		"7d21c8 96ff00 96f900 ffffff 96ed00 96e700 96e100 96db00 ffffff 96cf00 "
+		"96c900 96c300 96bd00 ffffff 96b100 96ab00 96a500 969f00 ffffff 969300 "
+		"968d00 968700 968100 ffffff 967500 966f00 966900 966300 ffffff 965700 "
+		"965100 964b00 964500 ffffff 963900 963300 962d00 962700 ffffff afffc8 "
+		"aff9c8 aff3c8 afedc8 ffffff afe1c8 afdbc8 afd5c8 afcfc8 ffffff afc3c8 "
+		"afbdc8 afb7c8 afb1c8 ffffff afa5c8 af9fc8 af99c8 af93c8 ffffff af87c8 "
+		"af81c8 af7bc8 af75c8 ffffff af69c8 af63c8 af5dc8 af57c8 ffffff af4bc8 "
+		"af45c8 af3fc8 af39c8 ffffff af2dc8 af27c8 af21c8 c8ff00 ffffff c8f300 "
+		"c8ed00 c8e700 c8e100 ffffff c8d500 c8cf00 c8c900 c8c300 ffffff c8b700 "
+		"c8b100 c8ab00 c8a500 ffffff c89900 c89300 c88d00 c88700 ffffff c87b00 "
+		"c87500 c86f00 c86900 ffffff c85d00 c85700 c85100 c84b00 ffffff c83f00 "
+		"c83900 c83300 c82d00 ffffff c82100 e1ffc8 e1f9c8 e1f3c8 ffffff e1e7c8 "
+		"e1e1c8 e1dbc8 e1d5c8 ffffff e1c9c8 e1c3c8 e1bdc8 e1b7c8 ffffff e1abc8 "
+		"e1a5c8 e19fc8 e199c8 ffffff e18dc8 e187c8 e181c8 e17bc8 ffffff e16fc8 "
+		"e169c8 e163c8 e15dc8 ffffff e151c8 e14bc8 e145c8 e13fc8 ffffff e133c8 "
+		"e12dc8 e127c8 e121c8",
+		"2f2f2f 002e00 002d00 002c00 002b00 2f2f2f 002900 002700 002600 002500 "
+		"2f2f2f 002300 002200 002100 002000 2f2f2f 001d00 001c00 001b00 001a00 "
+		"2f2f2f 001800 001700 001500 001400 2f2f2f 001200 001100 001000 000f00 "
+		"2f2f2f 000c00 000b00 000a00 000900 2f2f2f 000700 000600 042f25 042e25 "
+		"2f2f2f 042c25 042b25 042a25 042925 2f2f2f 042625 042525 042425 042325 "
+		"2f2f2f 042125 042025 041e25 041d25 2f2f2f 041b25 041a25 041925 041825 "
+		"2f2f2f 041525 041425 041325 041225 2f2f2f 041025 040f25 040e25 040c25 "
+		"2f2f2f 040a25 040925 040825 040725 2f2f2f 092f00 092e00 092d00 092c00 "
+		"2f2f2f 092a00 092900 092700 092600 2f2f2f 092400 092300 092200 092100 "
+		"2f2f2f 091e00 091d00 091c00 091b00 2f2f2f 091900 091800 091700 091500 "
+		"2f2f2f 091300 091200 091100 091000 2f2f2f 090e00 090c00 090b00 090a00 "
+		"2f2f2f 090800 090700 090600 38x2f2f2f 122f00 122e00 122d00 2f2f2f 122b00 "
+		"122a00 122900 122700 2f2f2f 122500 122400 122300 122200 2f2f2f 122000 "
+		"121e00 121d00 121c00 2f2f2f 121a00 121900 121800 121700 2f2f2f 121400 "
+		"121300 121200 121100 2f2f2f 120f00 120e00 120c00 120b00 2f2f2f 120900 "
+		"120800 120700 120600 2f2f2f 172e25 172d25 172c25 172b25 2f2f2f 172925 "
+		"172725 172625 172525 2f2f2f 172325 172225 172125 172025 2f2f2f 171d25 "
+		"171c25 171b25 171a25 2f2f2f 171825 171725 171525 171425 2f2f2f 171225 "
+		"171125 171025 170f25 2f2f2f 170c25 170b25 170a25 170925 2f2f2f 170725 "
+		"170625 1c2f00 1c2e00 2f2f2f 1c2c00 1c2b00 1c2a00 1c2900 2f2f2f 1c2600 "
+		"1c2500 1c2400 1c2300 2f2f2f 1c2100 1c2000 1c1e00 1c1d00 2f2f2f 1c1b00 "
+		"1c1a00 1c1900 1c1800 2f2f2f 1c1500 1c1400 1c1300 1c1200 2f2f2f 1c1000 "
+		"1c0f00 1c0e00 1c0c00 2f2f2f 1c0a00 1c0900 1c0800 1c0700 2f2f2f 202f25 "
+		"202e25 202d25 202c25 2f2f2f 202a25 202925 202725 202625 2f2f2f 202425 "
+		"202325 202225 202125 2f2f2f 201e25 201d25 201c25 201b25 2f2f2f 201925 "
+		"201825 201725 201525 2f2f2f 201325 201225 201125 201025 2f2f2f 200e25 "
+		"200c25 200b25 200a25 2f2f2f 200825 200725 200625 252f00 2f2f2f 252d00 "
+		"252c00 252b00 252a00 2f2f2f 252700 252600 252500 252400 2f2f2f 252200 "
+		"252100 252000 251e00 2f2f2f 251c00 251b00 251a00 251900 2f2f2f 251700 "
+		"251500 251400 251300 2f2f2f 251100 251000 250f00 250e00 2f2f2f 250b00 "
+		"250a00 250900 250800 2f2f2f 250600 2a2f25 2a2e25 2a2d25 2f2f2f 2a2b25 "
+		"2a2a25 2a2925 2a2725 2f2f2f 2a2525 2a2425 2a2325 2a2225 2f2f2f 2a2025 "
+		"2a1e25 2a1d25 2a1c25 2f2f2f 2a1a25 2a1925 2a1825 2a1725 2f2f2f 2a1425 "
+		"2a1325 2a1225 2a1125 2f2f2f 2a0f25 2a0e25 2a0c25 2a0b25 2f2f2f 2a0925 "
+		"2a0825 2a0725 2a0625"}},
+};
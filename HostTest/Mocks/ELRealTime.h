@@ -0,0 +1,2 @@
+// Host build stand in, see FHHostMocks.h
+#include "../FHHostMocks.h"